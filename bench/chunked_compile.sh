@@ -0,0 +1,43 @@
+#!/usr/bin/env bash
+# Times the C++ compiler on one large generated program, first with every statement in
+# main() and then split into functions by --chunk-size. A single huge main() makes the
+# optimizer superlinear; the chunked builds should stay close to linear in the size.
+#
+# Usage: bench/chunked_compile.sh <humanscript_compiler> [variables] [chunk size...]
+#   variables   each adds a declaration and a 'says' (default 500)
+#   chunk size  sizes to compare against main() only (default 64 256)
+# Honors CXX (default g++).
+set -euo pipefail
+
+if [ $# -lt 1 ]; then
+    sed -n '2,8p' "$0"
+    exit 1
+fi
+compiler=$(realpath "$1")
+variables=${2:-500}
+if [ $# -gt 2 ]; then
+    chunk_sizes=("${@:3}")
+else
+    chunk_sizes=(64 256)
+fi
+cxx=${CXX:-g++}
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# Each variable extends the previous one, so nothing folds away
+{
+    echo 'text t0 := "a";'
+    for ((i = 1; i <= variables; i++)); do
+        echo "text t$i := t$((i - 1)) + $i;"
+        echo "says t$i + \"x\" + $i;"
+    done
+} > "$work/program.hs"
+
+TIMEFORMAT=%R
+for chunk_size in 0 "${chunk_sizes[@]}"; do
+    "$compiler" "$work/program.hs" --no-server --chunk-size="$chunk_size" -o_cpp "$work/program.cpp" > /dev/null
+    label=$([ "$chunk_size" = 0 ] && echo "main() only" || echo "--chunk-size=$chunk_size")
+    seconds=$( { time "$cxx" -std=c++17 -O2 -c "$work/program.cpp" -o "$work/program.o"; } 2>&1 )
+    printf '%-20s %8s s\n' "$label" "$seconds"
+done
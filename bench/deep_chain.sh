@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+# Times the compiler on one statement that concatenates N operands in a single left-leaning
+# chain, through --check (front end and optimizer) and both backends. Every pass walks such
+# chains in a loop, so the cost per term should stay flat as N grows.
+#
+# Usage: bench/deep_chain.sh <humanscript_compiler> [terms...]
+#   terms  chain lengths to time, multiples of 100 (default 10000 20000 50000 100000)
+set -euo pipefail
+
+if [ $# -lt 1 ]; then
+    sed -n '2,7p' "$0"
+    exit 1
+fi
+compiler=$(realpath "$1")
+if [ $# -gt 1 ]; then
+    term_counts=("${@:2}")
+else
+    term_counts=(10000 20000 50000 100000)
+fi
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work"
+
+# Alternate text and number operands so nothing folds and every term reaches the backend
+hundred_terms=$(printf ' + x + n%.0s' {1..50})
+
+TIMEFORMAT=%R
+printf '%-10s %-12s %10s %14s\n' terms mode seconds "us per term"
+for terms in "${term_counts[@]}"; do
+    {
+        echo 'text x := "a";'
+        echo 'number n := 1;'
+        printf 'says x'
+        for ((i = 0; i < terms / 100; i++)); do
+            printf '%s' "$hundred_terms"
+        done
+        echo ';'
+    } > chain.hs
+    for mode in --check --emit=cpp --emit=c; do
+        # Without -run the compiler stops once the generated code is written
+        seconds=$( { time "$compiler" chain.hs --no-server "$mode" > /dev/null; } 2>&1 )
+        per_term=$(awk -v s="$seconds" -v n="$terms" 'BEGIN { printf "%.3f", s * 1e6 / n }')
+        printf '%-10s %-12s %10s %14s\n' "$terms" "$mode" "$seconds" "$per_term"
+    done
+done
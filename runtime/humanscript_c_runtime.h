@@ -0,0 +1,201 @@
+/* HumanScript C runtime, embedded by the compiler into programs generated with --emit=c.
+ * Text values are length-prefixed views into string literals or into an arena that is never
+ * freed before exit. Values are formatted exactly like the C++ runtime (hs::format), so
+ * both backends print the same output. */
+#ifndef HUMANSCRIPT_C_RUNTIME_H
+#define HUMANSCRIPT_C_RUNTIME_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char* data;
+    size_t size;
+} hs_text;
+
+static inline _Bool hs_text_equal(hs_text a, hs_text b) {
+    return a.size == b.size && (a.size == 0 || memcmp(a.data, b.data, a.size) == 0);
+}
+
+/* Bump allocator for built text */
+static char* hs_arena_next;
+static size_t hs_arena_left;
+
+static inline char* hs_arena_alloc(size_t size) {
+    if (size > hs_arena_left) {
+        size_t chunk = size > ((size_t)1 << 20) ? size : ((size_t)1 << 20);
+        hs_arena_next = (char*)malloc(chunk);
+        if (!hs_arena_next) {
+            fputs("HumanScript: out of memory\n", stderr);
+            abort();
+        }
+        hs_arena_left = chunk;
+    }
+    char* block = hs_arena_next;
+    hs_arena_next += size;
+    hs_arena_left -= size;
+    return block;
+}
+
+/* Largest formatted value: "-2.2250738585072014e-308" (24 chars) for a double */
+#define HS_MAX_FORMATTED_SIZE 24
+
+static inline size_t hs_format_int(char* out, int value) {
+    char buffer[32];
+    int size = snprintf(buffer, sizeof buffer, "%d", value);
+    memcpy(out, buffer, (size_t)size);
+    return (size_t)size;
+}
+
+static inline size_t hs_format_long(char* out, long long value) {
+    char buffer[32];
+    int size = snprintf(buffer, sizeof buffer, "%lld", value);
+    memcpy(out, buffer, (size_t)size);
+    return (size_t)size;
+}
+
+static inline size_t hs_format_bool(char* out, _Bool value) {
+    memcpy(out, value ? "true" : "false", value ? 4 : 5);
+    return value ? 4 : 5;
+}
+
+/* Shortest text that reads back as the same double, choosing between fixed and
+ * scientific notation like std::to_chars: fewer characters wins, fixed on a tie */
+static inline size_t hs_format_double(char* out, double value) {
+    if (isnan(value)) {
+        const char* text = signbit(value) ? "-nan" : "nan";
+        memcpy(out, text, strlen(text));
+        return strlen(text);
+    }
+    if (isinf(value)) {
+        const char* text = value < 0 ? "-inf" : "inf";
+        memcpy(out, text, strlen(text));
+        return strlen(text);
+    }
+
+    char scientific[40];
+    int precision;
+    for (precision = 1; precision < 17; ++precision) {
+        snprintf(scientific, sizeof scientific, "%.*e", precision - 1, value);
+        if (strtod(scientific, NULL) == value) break;
+    }
+    snprintf(scientific, sizeof scientific, "%.*e", precision - 1, value);
+
+    /* Split "-d.ddde+XX" into sign, significant digits and decimal exponent */
+    const char* p = scientific;
+    _Bool negative = *p == '-';
+    if (negative) ++p;
+    char digits[20];
+    size_t digit_count = 0;
+    for (; *p != 'e'; ++p) {
+        if (*p != '.') digits[digit_count++] = *p;
+    }
+    int exponent = atoi(p + 1);
+    size_t scientific_size = strlen(scientific);
+
+    char fixed[400];
+    size_t fixed_size = 0;
+    if (negative) fixed[fixed_size++] = '-';
+    if (exponent >= 0 && (size_t)exponent + 1 >= digit_count) {
+        /* An integral value: like std::to_chars, print its exact digits, not zero padding */
+        fixed_size = (size_t)snprintf(fixed, sizeof fixed, "%.0f", value);
+    } else if (exponent >= 0) {
+        for (size_t i = 0; i < digit_count; ++i) {
+            if (i == (size_t)exponent + 1) fixed[fixed_size++] = '.';
+            fixed[fixed_size++] = digits[i];
+        }
+    } else {
+        fixed[fixed_size++] = '0';
+        fixed[fixed_size++] = '.';
+        for (int i = -1; i > exponent; --i) fixed[fixed_size++] = '0';
+        for (size_t i = 0; i < digit_count; ++i) fixed[fixed_size++] = digits[i];
+    }
+
+    if (fixed_size <= scientific_size) {
+        memcpy(out, fixed, fixed_size);
+        return fixed_size;
+    }
+    memcpy(out, scientific, scientific_size);
+    return scientific_size;
+}
+
+/* Text building: hs_begin reserves an upper bound on the final size in the arena, the
+ * hs_add_* calls append in place and hs_take pops the finished text. A stack lets a piece
+ * contain another concatenation (e.g. a comparison of two built texts). */
+typedef struct {
+    char* data;
+    size_t size;
+} hs_builder;
+
+static hs_builder* hs_builders;
+static size_t hs_builder_depth;
+static size_t hs_builder_capacity;
+
+static inline void hs_begin(size_t size_bound) {
+    if (hs_builder_depth == hs_builder_capacity) {
+        hs_builder_capacity = hs_builder_capacity ? hs_builder_capacity * 2 : 16;
+        hs_builders = (hs_builder*)realloc(hs_builders, hs_builder_capacity * sizeof *hs_builders);
+        if (!hs_builders) {
+            fputs("HumanScript: out of memory\n", stderr);
+            abort();
+        }
+    }
+    hs_builder* builder = &hs_builders[hs_builder_depth++];
+    builder->data = hs_arena_alloc(size_bound);
+    builder->size = 0;
+}
+
+static inline void hs_add_text(hs_text value) {
+    hs_builder* builder = &hs_builders[hs_builder_depth - 1];
+    if (value.size) memcpy(builder->data + builder->size, value.data, value.size);
+    builder->size += value.size;
+}
+
+static inline void hs_add_int(int value) {
+    hs_builder* builder = &hs_builders[hs_builder_depth - 1];
+    builder->size += hs_format_int(builder->data + builder->size, value);
+}
+
+static inline void hs_add_long(long long value) {
+    hs_builder* builder = &hs_builders[hs_builder_depth - 1];
+    builder->size += hs_format_long(builder->data + builder->size, value);
+}
+
+static inline void hs_add_double(double value) {
+    hs_builder* builder = &hs_builders[hs_builder_depth - 1];
+    builder->size += hs_format_double(builder->data + builder->size, value);
+}
+
+static inline void hs_add_bool(_Bool value) {
+    hs_builder* builder = &hs_builders[hs_builder_depth - 1];
+    builder->size += hs_format_bool(builder->data + builder->size, value);
+}
+
+static inline hs_text hs_take(void) {
+    hs_builder* builder = &hs_builders[--hs_builder_depth];
+    hs_text text = { builder->data, builder->size };
+    return text;
+}
+
+/* 'says': the value and a newline, written with fwrite */
+static inline void hs_say_text(hs_text value) {
+    fwrite(value.data, 1, value.size, stdout);
+    fputc('\n', stdout);
+}
+
+static inline void hs_say_formatted(const char* data, size_t size) {
+    char line[HS_MAX_FORMATTED_SIZE + 1];
+    memcpy(line, data, size);
+    line[size] = '\n';
+    fwrite(line, 1, size + 1, stdout);
+}
+
+static inline void hs_say_int(int value) { char b[HS_MAX_FORMATTED_SIZE]; hs_say_formatted(b, hs_format_int(b, value)); }
+static inline void hs_say_long(long long value) { char b[HS_MAX_FORMATTED_SIZE]; hs_say_formatted(b, hs_format_long(b, value)); }
+static inline void hs_say_double(double value) { char b[HS_MAX_FORMATTED_SIZE]; hs_say_formatted(b, hs_format_double(b, value)); }
+static inline void hs_say_bool(_Bool value) { char b[HS_MAX_FORMATTED_SIZE]; hs_say_formatted(b, hs_format_bool(b, value)); }
+
+#endif /* HUMANSCRIPT_C_RUNTIME_H */
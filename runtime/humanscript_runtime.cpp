@@ -0,0 +1,80 @@
+#include "humanscript_runtime.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#define HS_WRITE(data, size) _write(1, data, static_cast<unsigned>(size))
+#else
+#include <unistd.h>
+#define HS_WRITE(data, size) ::write(1, data, size)
+#endif
+
+namespace hs {
+
+namespace {
+
+template <typename Number>
+Formatted format_number(Number value) {
+    Formatted formatted;
+    auto result = std::to_chars(formatted.data, formatted.data + sizeof formatted.data, value);
+    formatted.size = static_cast<std::size_t>(result.ptr - formatted.data);
+    return formatted;
+}
+
+void write_all(const char* data, std::size_t size) {
+    while (size > 0) {
+        auto written = HS_WRITE(data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return; // Nowhere to report a failing stdout
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+} // namespace
+
+Formatted format(int value) { return format_number(value); }
+Formatted format(long long value) { return format_number(value); }
+Formatted format(double value) { return format_number(value); }
+
+Formatted format(bool value) {
+    Formatted formatted;
+    std::string_view text = value ? "true" : "false";
+    text.copy(formatted.data, text.size());
+    formatted.size = text.size();
+    return formatted;
+}
+
+TextBuilder& TextBuilder::add(int value) { return add(format(value).view()); }
+TextBuilder& TextBuilder::add(long long value) { return add(format(value).view()); }
+TextBuilder& TextBuilder::add(double value) { return add(format(value).view()); }
+TextBuilder& TextBuilder::add(bool value) { return add(format(value).view()); }
+
+void OutputBuffer::write(const char* data, std::size_t size) {
+    std::size_t filled = static_cast<std::size_t>(used);
+    if (size > sizeof buffer - filled) {
+        flush();
+        if (size >= sizeof buffer) {
+            write_all(data, size);
+            return;
+        }
+        filled = 0;
+    }
+    // Copied before 'used' grows, so a signal handler flushing meanwhile sees whole bytes only
+    std::memcpy(buffer + filled, data, size);
+    used = static_cast<std::sig_atomic_t>(filled + size);
+}
+
+void OutputBuffer::flush() {
+    // Emptied before writing: a signal arriving mid-write drops the rest instead of repeating it
+    std::size_t filled = static_cast<std::size_t>(used);
+    used = 0;
+    write_all(buffer, filled);
+}
+
+OutputBuffer standard_output;
+
+} // namespace hs
@@ -0,0 +1,87 @@
+// HumanScript runtime: value formatting, text building and buffered output.
+// Generated programs either include this header and link the humanscript_runtime library,
+// or get this header and humanscript_runtime.cpp embedded by the compiler. The compiler
+// links the same library for constant folding, so both sides format values identically.
+#ifndef HUMANSCRIPT_RUNTIME_H
+#define HUMANSCRIPT_RUNTIME_H
+
+#include <csignal>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace hs {
+
+// Largest formatted value: "-2.2250738585072014e-308" (24 chars) for a double
+constexpr std::size_t max_formatted_size = 24;
+
+// A formatted value held on the stack; no allocation, no locale
+struct Formatted {
+    char data[max_formatted_size];
+    std::size_t size = 0;
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+Formatted format(int value);
+Formatted format(long long value);
+Formatted format(double value); // Shortest text that reads back as the same double
+Formatted format(bool value);   // "true" or "false"
+
+// Builds a text value with a single allocation: the generated code passes an upper bound
+// on the final size, and numbers are formatted in place, never via std::string temporaries.
+class TextBuilder {
+public:
+    explicit TextBuilder(std::size_t size_bound) { text.reserve(size_bound); }
+    template <std::size_t N>
+    TextBuilder& add(const char (&literal)[N]) { text.append(literal, N - 1); return *this; }
+    TextBuilder& add(std::string_view value) { text.append(value); return *this; }
+    TextBuilder& add(const std::string& value) { text.append(value); return *this; }
+    TextBuilder& add(int value);
+    TextBuilder& add(long long value);
+    TextBuilder& add(double value);
+    TextBuilder& add(bool value);
+    std::string take() { return std::move(text); }
+
+private:
+    std::string text;
+};
+
+// Standard output buffered in a static array and drained with write(2); no <iostream>
+class OutputBuffer {
+public:
+    void write(const char* data, std::size_t size);
+    // Only write(2) and a sig_atomic_t store, so a SIGINT/SIGTERM handler may call it
+    void flush();
+
+private:
+    char buffer[1 << 16];
+    volatile std::sig_atomic_t used; // Zero-initialized: the only instance has static storage
+};
+extern OutputBuffer standard_output;
+
+// Writes one value to any stream-like sink with write(const char*, size)
+template <typename Out, std::size_t N>
+inline void put(Out& out, const char (&literal)[N]) { out.write(literal, N - 1); }
+template <typename Out>
+inline void put(Out& out, std::string_view value) { out.write(value.data(), value.size()); }
+template <typename Out>
+inline void put(Out& out, const std::string& value) { out.write(value.data(), value.size()); }
+template <typename Out>
+inline void put(Out& out, int value) { Formatted f = format(value); out.write(f.data, f.size); }
+template <typename Out>
+inline void put(Out& out, long long value) { Formatted f = format(value); out.write(f.data, f.size); }
+template <typename Out>
+inline void put(Out& out, double value) { Formatted f = format(value); out.write(f.data, f.size); }
+template <typename Out>
+inline void put(Out& out, bool value) { Formatted f = format(value); out.write(f.data, f.size); }
+
+// 'says': the value followed by a newline
+template <typename Out, typename T>
+inline void say(Out& out, const T& value) {
+    put(out, value);
+    out.write("\n", 1);
+}
+
+} // namespace hs
+
+#endif // HUMANSCRIPT_RUNTIME_H
@@ -0,0 +1,249 @@
+#include "algebraic_simplifier.h"
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace {
+bool is_integer_type(HScriptType type) {
+    return type == HScriptType::NUMBER || type == HScriptType::LNUMBER;
+}
+
+bool is_literal(const ExprNode* expr) {
+    return dynamic_cast<const IntegerLiteralNode*>(expr) || dynamic_cast<const DoubleLiteralNode*>(expr) ||
+           dynamic_cast<const StringLiteralNode*>(expr) || dynamic_cast<const BooleanLiteralNode*>(expr);
+}
+
+bool is_empty_text(const ExprNode* expr) {
+    auto str_lit = dynamic_cast<const StringLiteralNode*>(expr);
+    return str_lit && str_lit->value.empty();
+}
+
+bool is_integer_zero(const ExprNode* expr) {
+    auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr);
+    return int_lit && int_lit->value == 0;
+}
+
+const BinaryOpNode* as_plus(const ExprNode* expr) {
+    auto bin_op = dynamic_cast<const BinaryOpNode*>(expr);
+    return bin_op && bin_op->op_token.type == TokenType::PLUS ? bin_op : nullptr;
+}
+
+// Text form of a literal when concatenated, matching hs::TextBuilder in the generated code
+bool literal_text(const ExprNode* expr, std::string& out) {
+    if (auto str_lit = dynamic_cast<const StringLiteralNode*>(expr)) {
+        out = str_lit->value;
+        return true;
+    }
+    if (auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr)) {
+        out = std::to_string(int_lit->value);
+        return true;
+    }
+    return false;
+}
+
+std::unique_ptr<ExprNode> make_integer_literal(long long value, HScriptType type) {
+    auto literal = std::make_unique<IntegerLiteralNode>(value);
+    literal->expr_type = type;
+    literal->value_range = ValueRange{value, value};
+    return literal;
+}
+
+std::unique_ptr<ExprNode> make_text_literal(std::string value) {
+    return std::make_unique<StringLiteralNode>(std::move(value));
+}
+
+// Sum of two integer literals in 'type', or false if it would overflow that type
+bool add_in_type(long long left, long long right, HScriptType type, long long& sum) {
+    long long max = type == HScriptType::NUMBER ? std::numeric_limits<int>::max() : std::numeric_limits<long long>::max();
+    long long min = type == HScriptType::NUMBER ? std::numeric_limits<int>::min() : std::numeric_limits<long long>::min();
+    if ((right > 0 && left > max - right) || (right < 0 && left < min - right)) return false;
+    sum = left + right;
+    return true;
+}
+}
+
+AlgebraicSimplifier::AlgebraicSimplifier(bool verbose, DiagnosticStreams diagnostics) : verbose(verbose), diagnostics(diagnostics) {}
+
+const char* AlgebraicSimplifier::rule_name(Rule rule) {
+    switch (rule) {
+        case TEXT_EMPTY_IDENTITY:           return "text-empty-identity";
+        case INTEGER_ZERO_IDENTITY:         return "integer-zero-identity";
+        case TEXT_LITERAL_FOLD:             return "text-literal-fold";
+        case TEXT_LITERAL_REASSOCIATION:    return "text-literal-reassociation";
+        case INTEGER_LITERAL_FOLD:          return "integer-literal-fold";
+        case INTEGER_LITERAL_REASSOCIATION: return "integer-literal-reassociation";
+        case COMPARISON_CANONICALIZATION:   return "comparison-canonicalization";
+        case COMPARISON_SELF:               return "comparison-self";
+        case COMPARISON_WITH_TRUE:          return "comparison-with-true";
+        default:                            return "unknown";
+    }
+}
+
+void AlgebraicSimplifier::run(ProgramNode* program) {
+    rule_counts.fill(0);
+
+    for (const auto& stmt : program->statements) {
+        visit(stmt.get());
+    }
+
+    if (verbose) {
+        for (int rule = 0; rule < RULE_COUNT; ++rule) {
+            *diagnostics.info << "Optimizer Info: Simplifier rule '" << rule_name(static_cast<Rule>(rule)) << "' fired "
+                      << rule_counts[rule] << " time(s)" << std::endl;
+        }
+    }
+}
+
+void AlgebraicSimplifier::visit(StatementNode* stmt) {
+    if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt)) {
+        simplify(var_decl->expression);
+    } else if (auto says_stmt = dynamic_cast<SaysStatementNode*>(stmt)) {
+        simplify(says_stmt->expression);
+    } else if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt)) {
+        simplify(if_stmt->condition);
+        visit(if_stmt->then_branch.get());
+        if (if_stmt->else_branch) {
+            visit(if_stmt->else_branch.get());
+        }
+    } else if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            visit(s.get());
+        }
+    }
+}
+
+void AlgebraicSimplifier::simplify(std::unique_ptr<ExprNode>& root) {
+    // Post-order over the left spine without recursing per term: slots[i] owns the i-th spine node
+    std::vector<std::unique_ptr<ExprNode>*> slots;
+    std::unique_ptr<ExprNode>* slot = &root;
+    while (auto bin_op = dynamic_cast<BinaryOpNode*>(slot->get())) {
+        slots.push_back(slot);
+        slot = &bin_op->left;
+    }
+
+    for (size_t i = slots.size(); i-- > 0;) {
+        simplify(static_cast<BinaryOpNode*>(slots[i]->get())->right);
+        // A rewrite can enable another one at the same node (e.g. fold after reassociation)
+        while (apply_rule(*slots[i])) {
+        }
+    }
+}
+
+void AlgebraicSimplifier::fired(Rule rule, const std::string& before, const ExprNode* after) {
+    rule_counts[rule]++;
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: [" << rule_name(rule) << "] " << before << " -> " << after->to_string() << std::endl;
+    }
+}
+
+bool AlgebraicSimplifier::apply_rule(std::unique_ptr<ExprNode>& slot) {
+    auto bin_op = dynamic_cast<BinaryOpNode*>(slot.get());
+    if (!bin_op) return false;
+
+    ExprNode* left = bin_op->left.get();
+    ExprNode* right = bin_op->right.get();
+    HScriptType result_type = bin_op->expr_type;
+    std::string before = verbose ? bin_op->to_string() : std::string(); // to_string is linear in the subtree
+
+    if (bin_op->op_token.type == TokenType::PLUS) {
+        if (result_type == HScriptType::TEXT) {
+            if (is_empty_text(right) && left->expr_type == HScriptType::TEXT) {
+                slot = std::move(bin_op->left);
+                fired(TEXT_EMPTY_IDENTITY, before, slot.get());
+                return true;
+            }
+            if (is_empty_text(left) && right->expr_type == HScriptType::TEXT) {
+                slot = std::move(bin_op->right);
+                fired(TEXT_EMPTY_IDENTITY, before, slot.get());
+                return true;
+            }
+
+            std::string left_text, right_text;
+            if (literal_text(left, left_text) && literal_text(right, right_text)) {
+                slot = make_text_literal(left_text + right_text);
+                fired(TEXT_LITERAL_FOLD, before, slot.get());
+                return true;
+            }
+
+            // (x + "a") + "b" -> x + "ab": the inner sum is already text, so x is converted exactly once either way
+            auto inner_left = as_plus(left);
+            if (inner_left && inner_left->expr_type == HScriptType::TEXT && literal_text(right, right_text) &&
+                literal_text(inner_left->right.get(), left_text)) {
+                auto inner = static_cast<BinaryOpNode*>(bin_op->left.get());
+                inner->right = make_text_literal(left_text + right_text);
+                slot = std::move(bin_op->left);
+                fired(TEXT_LITERAL_REASSOCIATION, before, slot.get());
+                return true;
+            }
+            // "a" + ("b" + x) -> "ab" + x
+            auto inner_right = as_plus(right);
+            if (inner_right && inner_right->expr_type == HScriptType::TEXT && literal_text(left, left_text) &&
+                literal_text(inner_right->left.get(), right_text)) {
+                auto inner = static_cast<BinaryOpNode*>(bin_op->right.get());
+                inner->left = make_text_literal(left_text + right_text);
+                slot = std::move(bin_op->right);
+                fired(TEXT_LITERAL_REASSOCIATION, before, slot.get());
+                return true;
+            }
+        } else if (is_integer_type(result_type)) {
+            if (is_integer_zero(right) && left->expr_type == result_type) {
+                slot = std::move(bin_op->left);
+                fired(INTEGER_ZERO_IDENTITY, before, slot.get());
+                return true;
+            }
+            if (is_integer_zero(left) && right->expr_type == result_type) {
+                slot = std::move(bin_op->right);
+                fired(INTEGER_ZERO_IDENTITY, before, slot.get());
+                return true;
+            }
+
+            auto left_lit = dynamic_cast<IntegerLiteralNode*>(left);
+            auto right_lit = dynamic_cast<IntegerLiteralNode*>(right);
+            long long sum;
+            if (left_lit && right_lit && add_in_type(left_lit->value, right_lit->value, result_type, sum)) {
+                slot = make_integer_literal(sum, result_type);
+                fired(INTEGER_LITERAL_FOLD, before, slot.get());
+                return true;
+            }
+
+            // (x + 1) + 2 -> x + 3, only when both sums are computed in the same type
+            auto inner_left = as_plus(left);
+            if (inner_left && right_lit && inner_left->expr_type == result_type) {
+                auto inner_lit = dynamic_cast<IntegerLiteralNode*>(inner_left->right.get());
+                if (inner_lit && add_in_type(inner_lit->value, right_lit->value, result_type, sum)) {
+                    auto inner = static_cast<BinaryOpNode*>(bin_op->left.get());
+                    inner->right = make_integer_literal(sum, inner_lit->expr_type == HScriptType::LNUMBER ? HScriptType::LNUMBER : result_type);
+                    if (inner->value_range && bin_op->value_range) {
+                        inner->value_range = bin_op->value_range;
+                    }
+                    slot = std::move(bin_op->left);
+                    fired(INTEGER_LITERAL_REASSOCIATION, before, slot.get());
+                    return true;
+                }
+            }
+        }
+    } else if (bin_op->op_token.type == TokenType::QUESTION_EQUALS) {
+        if (is_literal(left) && !is_literal(right)) {
+            std::swap(bin_op->left, bin_op->right);
+            fired(COMPARISON_CANONICALIZATION, before, slot.get());
+            return true;
+        }
+
+        auto left_ident = dynamic_cast<const IdentifierNode*>(left);
+        auto right_ident = dynamic_cast<const IdentifierNode*>(right);
+        // riel is excluded because NaN never compares equal to itself
+        if (left_ident && right_ident && left_ident->name == right_ident->name && left->expr_type != HScriptType::RIEL) {
+            slot = std::make_unique<BooleanLiteralNode>(true);
+            fired(COMPARISON_SELF, before, slot.get());
+            return true;
+        }
+
+        auto right_bool = dynamic_cast<const BooleanLiteralNode*>(right);
+        if (right_bool && right_bool->value && left->expr_type == HScriptType::LOGIC) {
+            slot = std::move(bin_op->left);
+            fired(COMPARISON_WITH_TRUE, before, slot.get());
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "ast.h"
+#include "diagnostics.h"
+#include <array>
+#include <memory>
+
+// Peephole rewrites over BinaryOpNode. Every rule keeps the node's type under
+// SemanticAnalyzer::get_binary_op_result_type: a rule that drops an operand only
+// fires when the surviving operand already has the result type.
+class AlgebraicSimplifier {
+public:
+    enum Rule {
+        TEXT_EMPTY_IDENTITY,           // x + "" , "" + x          -> x       (x is text)
+        INTEGER_ZERO_IDENTITY,         // x + 0 , 0 + x            -> x       (x has the result type)
+        TEXT_LITERAL_FOLD,             // "a" + "b" , "a" + 1      -> "ab" , "a1"
+        TEXT_LITERAL_REASSOCIATION,    // (x + "a") + "b"          -> x + "ab"
+        INTEGER_LITERAL_FOLD,          // 1 + 2                    -> 3
+        INTEGER_LITERAL_REASSOCIATION, // (x + 1) + 2              -> x + 3
+        COMPARISON_CANONICALIZATION,   // 5 ?= x                   -> x ?= 5
+        COMPARISON_SELF,               // x ?= x                   -> true    (x is not riel)
+        COMPARISON_WITH_TRUE,          // b ?= true                -> b
+        RULE_COUNT
+    };
+
+    explicit AlgebraicSimplifier(bool verbose = false, DiagnosticStreams diagnostics = {});
+    void run(ProgramNode* program);
+
+    size_t fired_count(Rule rule) const { return rule_counts[rule]; }
+    static const char* rule_name(Rule rule);
+
+private:
+    bool verbose;
+    DiagnosticStreams diagnostics;
+    std::array<size_t, RULE_COUNT> rule_counts{};
+
+    void visit(StatementNode* stmt);
+    void simplify(std::unique_ptr<ExprNode>& slot);
+
+    // Applies the first matching rule to the binary operation in 'slot'; returns true if it rewrote it
+    bool apply_rule(std::unique_ptr<ExprNode>& slot);
+    void fired(Rule rule, const std::string& before, const ExprNode* after);
+};
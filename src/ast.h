@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include <variant>
+#include <optional>
 #include "lexer.h" // For Token
 
 // Enum to represent HumanScript types in the AST and Semantic Analyzer
@@ -26,9 +27,16 @@ inline std::string hscript_type_to_string(HScriptType type) {
 }
 
 
+// Inclusive range of values an integer expression can take
+struct ValueRange {
+    long long min;
+    long long max;
+};
+
 // --- Expression Nodes ---
 struct ExprNode {
     HScriptType expr_type = HScriptType::UNKNOWN; // To be filled by Semantic Analyzer
+    std::optional<ValueRange> value_range;         // To be filled by Range Analyzer (integer expressions only)
     virtual ~ExprNode() = default;
     virtual std::string to_string() const = 0;
 };
@@ -70,6 +78,13 @@ struct BinaryOpNode : ExprNode { // Renamed from BinaryOpExprNode
 
     BinaryOpNode(std::unique_ptr<ExprNode> l, Token op, std::unique_ptr<ExprNode> r)
         : left(std::move(l)), op_token(op), right(std::move(r)) {}
+    ~BinaryOpNode() override {
+        // Long '+' chains are left-leaning; unlink them one level at a time instead of
+        // recursing once per term (each replaced node is destroyed with an empty 'left')
+        while (auto left_op = dynamic_cast<BinaryOpNode*>(left.get())) {
+            left = std::move(left_op->left);
+        }
+    }
     std::string to_string() const override {
         return "(" + left->to_string() + " " + op_token.text + " " + right->to_string() + ")";
     }
@@ -0,0 +1,78 @@
+#include "backend_support.h"
+
+LiteralPool::LiteralPool(bool pools_empty_text) : pools_empty_text(pools_empty_text) {}
+
+void LiteralPool::clear() {
+    literals_.clear();
+    ids.clear();
+}
+
+void LiteralPool::collect(const ExprNode* expr) {
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        collect(bin_op->right.get());
+        expr = bin_op->left.get();
+    }
+    auto str_lit = dynamic_cast<const StringLiteralNode*>(expr);
+    if (str_lit && (pools_empty_text || !str_lit->value.empty()) && ids.emplace(str_lit->value, literals_.size()).second) {
+        literals_.push_back(&str_lit->value);
+    }
+}
+
+std::optional<size_t> LiteralPool::find(const std::string& value) const {
+    auto it = ids.find(value);
+    if (it == ids.end()) return std::nullopt;
+    return it->second;
+}
+
+std::string variable_name(const std::string& name) {
+    std::string mangled = "hs_v";
+    mangled.reserve(mangled.size() + name.size() * 2);
+    for (char c : name) {
+        if (c == '_') {
+            mangled += "_u";
+        } else {
+            mangled += c;
+        }
+    }
+    return mangled;
+}
+
+void emit_string_literal(Emitter& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            // -std=c99 turns trigraphs on, so "??/" would otherwise end up as a backslash
+            case '?': out << "\\?"; break;
+            default: out << c; break;
+        }
+    }
+    out << '"';
+}
+
+bool is_text_concat(const ExprNode* expr) {
+    auto bin_op = dynamic_cast<const BinaryOpNode*>(expr);
+    return bin_op && bin_op->op_token.type == TokenType::PLUS && bin_op->expr_type == HScriptType::TEXT;
+}
+
+void collect_concat_pieces(const ExprNode* expr, std::vector<const ExprNode*>& pieces) {
+    std::vector<const BinaryOpNode*> spine;
+    while (is_text_concat(expr)) {
+        auto bin_op = static_cast<const BinaryOpNode*>(expr);
+        spine.push_back(bin_op);
+        expr = bin_op->left.get();
+    }
+    pieces.push_back(expr);
+    for (size_t i = spine.size(); i-- > 0;) {
+        const ExprNode* right = spine[i]->right.get();
+        if (is_text_concat(right)) {
+            collect_concat_pieces(right, pieces);
+        } else {
+            pieces.push_back(right);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "ast.h"
+#include "emitter.h"
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Lowering shared by the C++ (CodeGenerator) and C (CBackend) backends
+
+// Distinct text literals in order of first use; both backends emit entry N as hs_lit<N>
+class LiteralPool {
+public:
+    // The C backend writes empty text inline and leaves it out of the pool
+    explicit LiteralPool(bool pools_empty_text = true);
+
+    void clear();
+    // Adds every literal in 'expr', iterating along the left spine like every other pass
+    void collect(const ExprNode* expr);
+    std::optional<size_t> find(const std::string& value) const;
+
+    const std::vector<const std::string*>& literals() const { return literals_; }
+    bool empty() const { return literals_.empty(); }
+
+private:
+    bool pools_empty_text;
+    std::vector<const std::string*> literals_;
+    std::unordered_map<std::string, size_t> ids;
+};
+
+// Name a HumanScript variable is emitted under. The prefix keeps user names clear of
+// everything else the generated code declares (hs, hs_state_, hs_lit<N>, the runtime)
+// and of C and C++ keywords. Every '_' in the name becomes "_u", so the result never
+// contains the "__" that C and C++ reserve: count -> hs_vcount, _x -> hs_v_ux.
+std::string variable_name(const std::string& name);
+
+// "value" with the escapes C and C++ share; '?' is escaped so no trigraph forms
+void emit_string_literal(Emitter& out, const std::string& value);
+
+// Text emitted around the operands of a binary operation: open, left, between, right, close
+struct BinaryOpPieces {
+    std::string open, between, close;
+};
+
+// Text '+' chains are flattened and built in one pass by each backend's runtime
+bool is_text_concat(const ExprNode* expr);
+// The operands of a text '+' chain from left to right, including those of parenthesized
+// text on the right: "a" + ("b" + c)
+void collect_concat_pieces(const ExprNode* expr, std::vector<const ExprNode*>& pieces);
+
+// Long '+' chains parse left-leaning, so walk the left spine iteratively instead of
+// recursing once per term: open every level, emit the innermost left operand, then close
+// the levels from the inside out. A text concatenation ends the spine and is emitted as
+// an operand.
+template <typename PiecesOf, typename EmitOperand>
+void emit_binary_spine(const BinaryOpNode* expr, Emitter& out, PiecesOf pieces_of, EmitOperand emit_operand) {
+    std::vector<const BinaryOpNode*> spine;
+    std::vector<BinaryOpPieces> spine_pieces;
+    const ExprNode* node = expr;
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(node)) {
+        if (is_text_concat(bin_op)) break;
+        spine.push_back(bin_op);
+        spine_pieces.push_back(pieces_of(bin_op));
+        out << spine_pieces.back().open;
+        node = bin_op->left.get();
+    }
+
+    emit_operand(node);
+    for (size_t i = spine.size(); i-- > 0;) {
+        out << spine_pieces[i].between;
+        emit_operand(spine[i]->right.get());
+        out << spine_pieces[i].close;
+    }
+}
@@ -0,0 +1,123 @@
+#include "batch.h"
+#include "job_limiter.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+struct FileResult {
+    std::ostringstream out;
+    std::ostringstream err;
+    int status = 0;
+    bool done = false;
+};
+
+void expand_into(const std::string& argument, std::vector<std::string>& result, int depth) {
+    if (argument.size() < 2 || argument[0] != '@') {
+        result.push_back(argument);
+        return;
+    }
+    if (depth > 16) {
+        throw std::runtime_error("Response file '" + argument.substr(1) + "' includes itself");
+    }
+    std::ifstream file(argument.substr(1));
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open response file '" + argument.substr(1) + "'");
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    std::string current;
+    bool in_word = false;
+    char quote = 0;
+    for (char c : text) {
+        if (quote) {
+            if (c == quote) quote = 0; else current += c;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            in_word = true;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            if (in_word) expand_into(current, result, depth + 1);
+            current.clear();
+            in_word = false;
+        } else {
+            current += c;
+            in_word = true;
+        }
+    }
+    if (in_word) expand_into(current, result, depth + 1);
+}
+
+} // namespace
+
+std::vector<std::string> expand_response_files(const std::vector<std::string>& arguments) {
+    std::vector<std::string> result;
+    for (const auto& argument : arguments) {
+        expand_into(argument, result, 0);
+    }
+    return result;
+}
+
+int compile_batch(const std::vector<std::string>& input_filenames, const DriverOptions& options, size_t threads, size_t jobs,
+                  CompilerSession& session, std::ostream& out, std::ostream& err) {
+    JobLimiter job_limiter(jobs);
+    CompileContext context{nullptr, &job_limiter, session.analysis_cache()};
+    if (options.run_after_compile && !options.check_only) {
+        try {
+            context.backend = &session.backend(options); // One toolchain lookup for the batch
+            context.backend->prepare(out, err);
+        } catch (const std::exception& e) {
+            err << "\nCompilation Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<FileResult> results(input_filenames.size());
+    std::atomic<size_t> next_file{0};
+    std::mutex mutex;
+    std::condition_variable file_done;
+
+    auto worker = [&] {
+        for (size_t i = next_file++; i < input_filenames.size(); i = next_file++) {
+            FileResult& result = results[i];
+            result.status = compile_file(input_filenames[i], options, context, result.out, result.err);
+            std::lock_guard<std::mutex> lock(mutex);
+            result.done = true;
+            file_done.notify_one();
+        }
+    };
+    threads = std::max<size_t>(1, std::min(threads, input_filenames.size()));
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    // Each file's messages go out whole, in input order, once the file is finished
+    size_t failures = 0;
+    for (auto& result : results) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            file_done.wait(lock, [&] { return result.done; });
+        }
+        out << result.out.str() << std::flush;
+        err << result.err.str() << std::flush;
+        if (result.status != 0) ++failures;
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    out << "\nCompiled " << input_filenames.size() - failures << " of " << input_filenames.size() << " HumanScript file(s)";
+    if (failures > 0) {
+        out << "; " << failures << " failed";
+    }
+    out << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "driver.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Compiles many scripts in one process: 'threads' workers run the front end of one file
+// each, and with -run the backend compiles and program runs are bounded by 'jobs' (shared
+// with a GNU make jobserver when present). Every file's messages are buffered and printed
+// whole, in input order, as soon as all earlier files are done, so the output does not depend
+// on scheduling; they go to 'out' and 'err'. The backend comes from 'session'. Returns 0 when
+// every file succeeded, 1 otherwise.
+int compile_batch(const std::vector<std::string>& input_filenames, const DriverOptions& options, size_t threads, size_t jobs,
+                  CompilerSession& session, std::ostream& out, std::ostream& err);
+
+// Expands "@file" arguments into the whitespace-separated paths the file lists (quotes
+// group paths with spaces; nested @files are expanded too). Throws std::runtime_error when
+// a response file cannot be read.
+std::vector<std::string> expand_response_files(const std::vector<std::string>& arguments);
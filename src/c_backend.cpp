@@ -0,0 +1,312 @@
+#include "c_backend.h"
+#include "humanscript_runtime.h"
+#include "runtime_source.h"
+#include <stdexcept>
+
+CBackend::CBackend(CodeGeneratorOptions options) : options(options) {}
+
+std::string CBackend::generate(const ProgramNode* program) {
+    MemorySink sink;
+    Emitter emitter(sink);
+    generate(program, emitter);
+    emitter.flush();
+    return sink.take();
+}
+
+void CBackend::generate(const ProgramNode* program, Emitter& emitter) {
+    out = &emitter;
+    literal_pool.clear();
+    assigned_variables.clear();
+
+    *out << "/* Generated by HumanScript Compiler (C backend) */\n\n";
+    for (const auto& use_decl : program->use_declarations) {
+        // 'use' names C++ headers; nothing in the C backend needs them
+        *out << "/* use <" << use_decl->header_name << "> is ignored by the C backend */\n";
+    }
+
+    bool says_is_used = false;
+    for (const auto& stmt : program->statements) {
+        scan(stmt.get(), says_is_used);
+    }
+
+    *out << "/* --- HumanScript C runtime (runtime/humanscript_c_runtime.h) --- */\n";
+    *out << HUMANSCRIPT_C_RUNTIME_SOURCE;
+    *out << "/* --- End of HumanScript C runtime --- */\n\n";
+    if (says_is_used) {
+        generate_says_output_setup();
+    }
+    generate_literal_pool();
+
+    *out << "int main(void) {\n";
+    if (says_is_used) {
+        *out << "    hs_setup_stdout();\n";
+    }
+    for (const auto& stmt : program->statements) {
+        *out << "    ";
+        visit(stmt.get());
+        if (dynamic_cast<const BlockStatementNode*>(stmt.get())) {
+            *out << "\n"; // Blocks leave the line open for a following 'else'
+        }
+    }
+    *out << "    return 0;\n";
+    *out << "}\n";
+    out = nullptr;
+}
+
+void CBackend::scan(const StatementNode* stmt, bool& says_is_used) {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        literal_pool.collect(var_decl->expression.get());
+    } else if (auto says_node = dynamic_cast<const SaysStatementNode*>(stmt)) {
+        says_is_used = true;
+        literal_pool.collect(says_node->expression.get());
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        literal_pool.collect(if_stmt->condition.get());
+        scan(if_stmt->then_branch.get(), says_is_used);
+        if (if_stmt->else_branch) {
+            scan(if_stmt->else_branch.get(), says_is_used);
+        }
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            scan(s.get(), says_is_used);
+        }
+    } else if (auto assignment = dynamic_cast<const AssignmentNode*>(stmt)) {
+        assigned_variables.insert(assignment->identifier_name);
+        literal_pool.collect(assignment->expression.get());
+    }
+}
+
+void CBackend::generate_literal_pool() {
+    const std::vector<const std::string*>& literals = literal_pool.literals();
+    for (size_t id = 0; id < literals.size(); ++id) {
+        *out << "static const hs_text hs_lit" << std::to_string(id) << " = { ";
+        emit_string_literal(*out, *literals[id]);
+        *out << ", " << std::to_string(literals[id]->size()) << " };\n";
+    }
+    if (!literal_pool.empty()) {
+        *out << "\n";
+    }
+}
+
+void CBackend::generate_says_output_setup() {
+    // stdio does the buffering: a 64 KiB buffer, line-buffered when --says-buffering asks
+    // for it (or, in auto mode, when stdout is a terminal). exit() flushes it. Nothing does
+    // on SIGINT/SIGTERM: fflush is not async-signal-safe.
+    if (options.says_buffering == SaysBuffering::AUTO) {
+        *out << "#ifdef _WIN32\n";
+        *out << "#include <io.h>\n";
+        *out << "#define HS_STDOUT_IS_TTY() (_isatty(1) != 0)\n";
+        *out << "#else\n";
+        *out << "#include <unistd.h>\n";
+        *out << "#define HS_STDOUT_IS_TTY() (isatty(1) != 0)\n";
+        *out << "#endif\n";
+    }
+    *out << "\n";
+    *out << "static char hs_stdout_buffer[1 << 16];\n";
+    *out << "static void hs_setup_stdout(void) {\n";
+    switch (options.says_buffering) {
+        case SaysBuffering::LINE:
+            *out << "    setvbuf(stdout, hs_stdout_buffer, _IOLBF, sizeof hs_stdout_buffer);\n";
+            break;
+        case SaysBuffering::FULL:
+            *out << "    setvbuf(stdout, hs_stdout_buffer, _IOFBF, sizeof hs_stdout_buffer);\n";
+            break;
+        case SaysBuffering::AUTO:
+            *out << "    setvbuf(stdout, hs_stdout_buffer, HS_STDOUT_IS_TTY() ? _IOLBF : _IOFBF, sizeof hs_stdout_buffer);\n";
+            break;
+    }
+    *out << "}\n\n";
+}
+
+std::string CBackend::c_type(HScriptType type) {
+    switch (type) {
+        case HScriptType::NUMBER:  return "int";
+        case HScriptType::LNUMBER: return "long long";
+        case HScriptType::TEXT:    return "hs_text";
+        case HScriptType::LOGIC:   return "_Bool";
+        case HScriptType::RIEL:    return "double";
+        default:
+            throw std::runtime_error("CBackend Error: Cannot map HScriptType " + hscript_type_to_string(type) + " to a C type.");
+    }
+}
+
+const char* CBackend::runtime_suffix(HScriptType type) {
+    switch (type) {
+        case HScriptType::NUMBER:  return "int";
+        case HScriptType::LNUMBER: return "long";
+        case HScriptType::TEXT:    return "text";
+        case HScriptType::LOGIC:   return "bool";
+        case HScriptType::RIEL:    return "double";
+        default:
+            throw std::runtime_error("CBackend Error: No runtime support for HScriptType " + hscript_type_to_string(type) + ".");
+    }
+}
+
+// --- Statement Visitors ---
+void CBackend::visit(const StatementNode* stmt) {
+    if (auto var_decl_stmt = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        visit(var_decl_stmt);
+    } else if (auto says_stmt = dynamic_cast<const SaysStatementNode*>(stmt)) {
+        visit(says_stmt);
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        visit(if_stmt);
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        visit(block_stmt);
+    } else {
+        throw std::runtime_error("CBackend Error: Unknown statement node type for code generation.");
+    }
+}
+
+void CBackend::visit(const VariableDeclarationNode* stmt) {
+    if (assigned_variables.count(stmt->identifier_name) == 0) {
+        *out << "const ";
+    }
+    *out << c_type(stmt->var_type) << " " << variable_name(stmt->identifier_name) << " = ";
+    if (stmt->var_type == HScriptType::NUMBER && stmt->expression->expr_type == HScriptType::LNUMBER) {
+        // Narrowing a widened initializer back to int, as the C++ backend does
+        *out << "(int)(";
+        generate_expression(stmt->expression.get());
+        *out << ")";
+    } else {
+        generate_expression(stmt->expression.get());
+    }
+    *out << ";\n";
+}
+
+void CBackend::visit(const SaysStatementNode* stmt) {
+    *out << "hs_say_" << runtime_suffix(stmt->expression->expr_type) << "(";
+    generate_expression(stmt->expression.get());
+    *out << ");\n";
+}
+
+void CBackend::visit(const IfStatementNode* stmt) {
+    *out << "if (";
+    generate_expression(stmt->condition.get());
+    *out << ") ";
+    if (dynamic_cast<const BlockStatementNode*>(stmt->then_branch.get())) {
+        visit(stmt->then_branch.get());
+    } else {
+        *out << "{\n        ";
+        visit(stmt->then_branch.get());
+        *out << "    }";
+    }
+    if (stmt->else_branch) {
+        *out << " else ";
+        if (dynamic_cast<const BlockStatementNode*>(stmt->else_branch.get())) {
+            visit(stmt->else_branch.get());
+        } else {
+            *out << "{\n        ";
+            visit(stmt->else_branch.get());
+            *out << "    }";
+        }
+    }
+    *out << "\n";
+}
+
+void CBackend::visit(const BlockStatementNode* stmt) {
+    *out << "{\n";
+    for (const auto& s : stmt->statements) {
+        *out << "        ";
+        visit(s.get());
+    }
+    *out << "    }";
+}
+
+// --- Expressions ---
+void CBackend::generate_expression(const ExprNode* expr) {
+    if (auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr)) {
+        *out << std::to_string(int_lit->value);
+        if (expr->expr_type != HScriptType::NUMBER) {
+            *out << "LL";
+        }
+    } else if (auto dbl_lit = dynamic_cast<const DoubleLiteralNode*>(expr)) {
+        hs::Formatted formatted = hs::format(dbl_lit->value);
+        std::string_view s = formatted.view();
+        *out << s;
+        if (s.find('.') == std::string_view::npos && s.find('e') == std::string_view::npos) {
+            *out << ".0";
+        }
+    } else if (auto str_lit = dynamic_cast<const StringLiteralNode*>(expr)) {
+        if (str_lit->value.empty()) {
+            *out << "((hs_text){ \"\", 0 })";
+        } else {
+            std::optional<size_t> id = literal_pool.find(str_lit->value);
+            if (!id) {
+                throw std::runtime_error("CBackend Error: Text literal missing from the literal pool.");
+            }
+            *out << "hs_lit" << std::to_string(*id);
+        }
+    } else if (auto bool_lit = dynamic_cast<const BooleanLiteralNode*>(expr)) {
+        *out << (bool_lit->value ? "1" : "0");
+    } else if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        *out << variable_name(ident->name);
+    } else if (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        generate_binary(bin_op);
+    } else {
+        throw std::runtime_error("CBackend Error: Unknown expression node type for code generation.");
+    }
+}
+
+BinaryOpPieces CBackend::binary_op_pieces(const BinaryOpNode* expr) {
+    switch (expr->op_token.type) {
+        case TokenType::PLUS:
+            // Text '+' never gets here: concatenation chains go through generate_text_concat
+            if (expr->expr_type == HScriptType::LNUMBER && expr->left->expr_type == HScriptType::NUMBER &&
+                expr->right->expr_type == HScriptType::NUMBER) {
+                return {"((long long)", " + ", ")"}; // RangeAnalyzer widened this sum
+            }
+            return {"(", " + ", ")"};
+        case TokenType::QUESTION_EQUALS:
+            if (expr->left->expr_type == HScriptType::TEXT) {
+                return {"hs_text_equal(", ", ", ")"};
+            }
+            return {"(", " == ", ")"};
+        default:
+            throw std::runtime_error("CBackend Error: Unsupported binary operator token for C code generation: " + expr->op_token.text);
+    }
+}
+
+void CBackend::generate_binary(const BinaryOpNode* expr) {
+    if (is_text_concat(expr)) {
+        generate_text_concat(expr);
+        return;
+    }
+
+    emit_binary_spine(expr, *out, binary_op_pieces, [this](const ExprNode* operand) { generate_expression(operand); });
+}
+
+void CBackend::generate_text_concat(const BinaryOpNode* expr) {
+    // A comma expression over the runtime's builder stack: reserve an upper bound on the
+    // final size once, append every piece in place, then take the finished view
+    std::vector<const ExprNode*> pieces;
+    collect_concat_pieces(expr, pieces);
+
+    size_t constant_bound = 0;
+    std::vector<const IdentifierNode*> text_variables;
+    for (const ExprNode* piece : pieces) {
+        if (auto str_lit = dynamic_cast<const StringLiteralNode*>(piece)) {
+            constant_bound += str_lit->value.size();
+        } else if (piece->expr_type == HScriptType::TEXT) {
+            if (auto ident = dynamic_cast<const IdentifierNode*>(piece)) {
+                text_variables.push_back(ident);
+            }
+        } else if (piece->expr_type == HScriptType::LOGIC) {
+            constant_bound += 5; // "false"
+        } else {
+            constant_bound += hs::max_formatted_size;
+        }
+    }
+
+    *out << "(hs_begin(" << std::to_string(constant_bound);
+    for (const IdentifierNode* ident : text_variables) {
+        *out << " + " << variable_name(ident->name) << ".size";
+    }
+    *out << ")";
+    for (const ExprNode* piece : pieces) {
+        auto str_lit = dynamic_cast<const StringLiteralNode*>(piece);
+        if (str_lit && str_lit->value.empty()) continue;
+        *out << ", hs_add_" << runtime_suffix(piece->expr_type) << "(";
+        generate_expression(piece);
+        *out << ")";
+    }
+    *out << ", hs_take())";
+}
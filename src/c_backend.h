@@ -0,0 +1,50 @@
+#pragma once
+#include "ast.h"
+#include "backend_support.h"
+#include "code_generator.h" // CodeGeneratorOptions
+#include "emitter.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Generates C99 instead of C++ (--emit=c). Text lowers to hs_text, a length-prefixed view
+// into string literals or an arena (runtime/humanscript_c_runtime.h); logic lowers to _Bool
+// and 'says' to fwrite on stdout. Only says_buffering is honored from the options.
+class CBackend {
+public:
+    explicit CBackend(CodeGeneratorOptions options = {});
+    // Streams the generated C to 'emitter'; the caller flushes it
+    void generate(const ProgramNode* program, Emitter& emitter);
+    // Convenience wrapper that collects the generated C in memory
+    std::string generate(const ProgramNode* program);
+
+private:
+    CodeGeneratorOptions options;
+    Emitter* out = nullptr;
+
+    // Non-empty text literals, emitted as hs_lit<N>; empty text is written inline, so an
+    // unused pool entry never trips -Wunused
+    LiteralPool literal_pool{false};
+    // Variables that are never assigned are declared const
+    std::unordered_set<std::string> assigned_variables;
+
+    void scan(const StatementNode* stmt, bool& says_is_used);
+    void generate_literal_pool();
+    void generate_says_output_setup();
+
+    static std::string c_type(HScriptType type);
+    static const char* runtime_suffix(HScriptType type); // hs_say_<suffix>, hs_add_<suffix>
+
+    // Statement code generation
+    void visit(const StatementNode* stmt);
+    void visit(const VariableDeclarationNode* stmt);
+    void visit(const SaysStatementNode* stmt);
+    void visit(const IfStatementNode* stmt);
+    void visit(const BlockStatementNode* stmt);
+
+    // Expression code generation
+    void generate_expression(const ExprNode* expr);
+    void generate_binary(const BinaryOpNode* expr);
+    void generate_text_concat(const BinaryOpNode* expr);
+    static BinaryOpPieces binary_op_pieces(const BinaryOpNode* expr);
+};
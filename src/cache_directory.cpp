@@ -0,0 +1,76 @@
+#include "cache_directory.h"
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Creates 'directory' (private to this user) if needed. False when it cannot be created.
+bool create_private_directory(const fs::path& directory) {
+    std::error_code error;
+    #ifdef _WIN32
+    fs::create_directories(directory, error);
+    return !error && fs::is_directory(directory, error);
+    #else
+    if (directory.has_parent_path()) {
+        fs::create_directories(directory.parent_path(), error);
+        if (error) return false;
+    }
+    return ::mkdir(directory.c_str(), 0700) == 0 || errno == EEXIST;
+    #endif
+}
+
+// The cache holds executables that -run starts without compiling and the compile server's
+// socket, so it must be a real directory that no other user can write to
+bool is_safe_cache_directory(const fs::path& directory) {
+    #ifdef _WIN32
+    std::error_code error;
+    return fs::is_directory(directory, error);
+    #else
+    struct stat info;
+    if (::lstat(directory.c_str(), &info) != 0) return false;
+    return S_ISDIR(info.st_mode) && info.st_uid == ::geteuid() && (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+    #endif
+}
+
+} // namespace
+
+std::string humanscript_cache_directory() {
+    std::vector<fs::path> candidates;
+    if (const char* dir = std::getenv("HUMANSCRIPT_CACHE_DIR"); dir && *dir) {
+        candidates.emplace_back(dir);
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        candidates.push_back(fs::path(xdg) / "humanscript");
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        candidates.push_back(fs::path(home) / ".cache" / "humanscript");
+    }
+    std::error_code error;
+    fs::path temp = fs::temp_directory_path(error);
+    if (!error) {
+        // The temporary directory is shared, so every user gets their own cache there
+        #ifdef _WIN32
+        candidates.push_back(temp / "humanscript-cache");
+        #else
+        candidates.push_back(temp / ("humanscript-cache-" + std::to_string(::geteuid())));
+        #endif
+    }
+
+    for (const auto& candidate : candidates) {
+        if (!create_private_directory(candidate)) continue;
+        // A directory someone else owns or can write to may hold planted executables;
+        // caching is turned off rather than trusting it or falling back to another one
+        return is_safe_cache_directory(candidate) ? candidate.string() : "";
+    }
+    return "";
+}
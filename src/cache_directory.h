@@ -0,0 +1,8 @@
+#pragma once
+#include <string>
+
+// Per-user cache for build artifacts: $HUMANSCRIPT_CACHE_DIR, else $XDG_CACHE_HOME/humanscript,
+// else ~/.cache/humanscript, else <temp>/humanscript-cache-<uid>. Created with mode 0700 on
+// first use; returns an empty string (caching off) when no directory can be created or the
+// first one that can is not owned by the current user or is writable by group or others.
+std::string humanscript_cache_directory();
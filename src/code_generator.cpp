@@ -1,7 +1,10 @@
 #include "code_generator.h"
 #include <iostream> // For debugging output from generator itself
+#include <algorithm> // For std::find_if over use declarations
+#include "humanscript_runtime.h"
+#include "runtime_source.h"
 
-CodeGenerator::CodeGenerator() {}
+CodeGenerator::CodeGenerator(CodeGeneratorOptions options) : options(options) {}
 
 std::string CodeGenerator::hscript_type_to_cpp_type(HScriptType type) {
     switch (type) {
@@ -17,17 +20,52 @@ std::string CodeGenerator::hscript_type_to_cpp_type(HScriptType type) {
 }
 
 std::string CodeGenerator::generate(const ProgramNode* program) {
-    output_stream.str(""); 
-    output_stream.clear(); 
+    MemorySink sink;
+    Emitter emitter(sink);
+    generate(program, emitter);
+    emitter.flush();
+    return sink.take();
+}
+
+void CodeGenerator::generate(const ProgramNode* program, Emitter& emitter) {
+    generate_program(program, emitter, {});
+}
+
+SplitProgram CodeGenerator::generate_split(const ProgramNode* program) {
+    size_t unit_count = std::max<size_t>(1, options.translation_units);
+    MemorySink header_sink;
+    Emitter header(header_sink);
+    std::vector<MemorySink> unit_sinks(unit_count);
+    std::vector<std::unique_ptr<Emitter>> unit_emitters;
+    std::vector<Emitter*> units;
+    for (auto& sink : unit_sinks) {
+        unit_emitters.push_back(std::make_unique<Emitter>(sink));
+        units.push_back(unit_emitters.back().get());
+    }
+    generate_program(program, header, units);
+
+    SplitProgram split;
+    header.flush();
+    split.header = header_sink.take();
+    for (size_t i = 0; i < unit_count; ++i) {
+        unit_emitters[i]->flush();
+        if (i == 0 || !unit_sinks[i].str().empty()) {
+            split.units.push_back(unit_sinks[i].take());
+        }
+    }
+    return split;
+}
+
+void CodeGenerator::generate_program(const ProgramNode* program, Emitter& emitter, const std::vector<Emitter*>& units) {
+    out = &emitter;
     iostream_included = false; // Reset for each generation
-    bool string_needed_for_says = false; // For std::to_string
 
-    output_stream << "// Generated by HumanScript Compiler\n\n";
+    *out << "// Generated by HumanScript Compiler\n\n";
 
     // 1. Process 'use' declarations from ProgramNode
     for (const auto& use_decl : program->use_declarations) {
         // Assuming all are system includes for now as we only parse use <...>
-        output_stream << "#include <" << use_decl->header_name << ">\n";
+        *out << "#include <" << use_decl->header_name << ">\n";
         if (use_decl->header_name == "iostream") {
             iostream_included = true;
         }
@@ -38,71 +76,410 @@ std::string CodeGenerator::generate(const ProgramNode* program) {
     }
     // Add a newline if any includes were generated
     if (!program->use_declarations.empty()) {
-        output_stream << "\n";
+        *out << "\n";
     }
 
     // Auto-include for 'says' if not already brought in by a 'use <iostream>;'
-    // Also include <string> for std::to_string if 'says' is used with non-string types
-    // And <iomanip> for std::boolalpha
+    // Values are printed and concatenated through the embedded runtime (hs::say, hs::TextBuilder)
     bool says_is_used = false;
     bool text_type_is_used = false;
+    bool text_concat_is_used = false;
+    literal_pool.clear();
+    assigned_variables.clear();
+    constexpr_variables.clear();
+    state_variables.clear();
     for (const auto& stmt : program->statements) {
-        if (dynamic_cast<const SaysStatementNode*>(stmt.get())) {
-            says_is_used = true;
+        scan_features(stmt.get(), says_is_used, text_type_is_used, text_concat_is_used);
+    }
+    if (text_concat_is_used) {
+        text_type_is_used = true; // The builder returns std::string
+    }
+
+    if (text_type_is_used && program->use_declarations.end() == std::find_if(program->use_declarations.begin(), program->use_declarations.end(), [](const auto& u){ return u->header_name == "string"; })) {
+         *out << "#include <string> // Auto-included for text type or string operations\n";
+    }
+
+    if (says_is_used && !iostream_included && options.runtime == RuntimeKind::IOSTREAM) {
+        *out << "#include <iostream> // Auto-included for 'says'\n";
+        iostream_included = true; // Mark it as included
+    }
+    if (!literal_pool.empty()) {
+        *out << "#include <string_view> // For the text literal pool\n";
+    }
+    *out << "\n";
+
+    if (says_is_used || text_concat_is_used) {
+        generate_runtime(units.empty() ? nullptr : units[0]);
+    }
+    if (says_is_used) {
+        generate_says_output_declarations(units.empty() ? "static" : "inline");
+        if (!units.empty()) {
+            out = units[0]; // Only main() sets up stdout
+            generate_says_output_setup();
+            out = &emitter;
+        } else {
+            generate_says_output_setup();
+        }
+    }
+    generate_literal_pool();
+
+    if (!units.empty()) {
+        generate_chunked_main(program, says_is_used, units);
+        out = nullptr;
+        return;
+    }
+    if (options.chunk_size > 0) {
+        generate_chunked_main(program, says_is_used);
+        out = nullptr;
+        return;
+    }
+
+    *out << "int main() {\n";
+    if (says_is_used) {
+        *out << "    hs_setup_stdout();\n";
+    }
+
+    for (const auto& stmt : program->statements) {
+        generate_top_level_statement(stmt.get());
+    }
+
+    *out << "    return 0;\n";
+    *out << "}\n";
+    out = nullptr;
+}
+
+void CodeGenerator::generate_top_level_statement(const StatementNode* stmt) {
+    *out << "    "; // Indentation
+    visit(stmt); // visit methods for VariableDeclarationNode, SaysStatementNode, etc.
+    if (dynamic_cast<const BlockStatementNode*>(stmt)) {
+        *out << "\n"; // Blocks leave the line open for a following 'else'
+    }
+}
+
+void CodeGenerator::generate_chunked_main(const ProgramNode* program, bool says_is_used, const std::vector<Emitter*>& units) {
+    // One huge main() makes the downstream compiler's register allocation and SSA construction
+    // superlinear, so top-level statements are split into functions of at most chunk_size
+    // statements (nested ones included; a single larger statement gets a chunk of its own).
+    const auto& statements = program->statements;
+    size_t chunk_size = options.chunk_size > 0 ? options.chunk_size : DEFAULT_SPLIT_CHUNK_SIZE;
+
+    // Constant top-level variables move to namespace scope where every chunk can see them
+    std::unordered_set<const StatementNode*> hoisted;
+    for (const auto& stmt : statements) {
+        auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt.get());
+        if (var_decl && assigned_variables.count(var_decl->identifier_name) == 0 && is_constant_expression(var_decl->expression.get())) {
+            constexpr_variables.insert(var_decl->identifier_name);
+            hoisted.insert(var_decl);
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> chunks; // [begin, end) into statements
+    std::vector<size_t> chunk_sizes;               // Statements in each chunk, nested ones included
+    size_t chunk_begin = 0;
+    size_t chunk_statements = 0;
+    for (size_t i = 0; i < statements.size(); ++i) {
+        size_t size = hoisted.count(statements[i].get()) ? 0 : count_statements(statements[i].get());
+        if (chunk_statements > 0 && size > 0 && chunk_statements + size > chunk_size) {
+            chunks.emplace_back(chunk_begin, i);
+            chunk_sizes.push_back(chunk_statements);
+            chunk_begin = i;
+            chunk_statements = 0;
         }
-        if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt.get())) {
-            if (var_decl->var_type == HScriptType::TEXT || 
-                (var_decl->expression && var_decl->expression->expr_type == HScriptType::TEXT) ) {
-                text_type_is_used = true;
+        chunk_statements += size;
+    }
+    if (chunk_begin < statements.size()) {
+        if (chunk_statements == 0 && !chunks.empty()) {
+            chunks.back().second = statements.size(); // Only hoisted constants left
+        } else {
+            chunks.emplace_back(chunk_begin, statements.size());
+            chunk_sizes.push_back(chunk_statements);
+        }
+    }
+
+    // Consecutive chunks go to the same unit, so that each unit gets a similar share of the
+    // statements. Units advance one at a time, and never so slowly that the remaining chunks
+    // could not give every remaining unit at least one.
+    std::vector<size_t> chunk_unit(chunks.size(), 0);
+    if (!units.empty()) {
+        size_t total = 0;
+        for (size_t size : chunk_sizes) total += size;
+        size_t before = 0;
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            size_t unit = total == 0 ? 0 : std::min(units.size() - 1, before * units.size() / total);
+            if (c > 0) {
+                unit = std::min(unit, chunk_unit[c - 1] + 1);
+            }
+            if (chunks.size() >= units.size() && c + units.size() > chunks.size()) {
+                unit = std::max(unit, c + units.size() - chunks.size());
             }
+            chunk_unit[c] = unit;
+            before += chunk_sizes[c];
         }
-         if (auto says_node = dynamic_cast<const SaysStatementNode*>(stmt.get())) {
-            if (says_node->expression && says_node->expression->expr_type == HScriptType::TEXT) {
-                text_type_is_used = true;
+    }
+
+    // Other top-level variables read outside their own chunk live in the state struct
+    std::unordered_map<std::string, size_t> declaring_chunk;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        for (size_t i = chunks[c].first; i < chunks[c].second; ++i) {
+            auto var_decl = dynamic_cast<const VariableDeclarationNode*>(statements[i].get());
+            if (var_decl && !hoisted.count(var_decl)) {
+                declaring_chunk[var_decl->identifier_name] = c;
+            }
+        }
+    }
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        std::unordered_set<std::string> names;
+        for (size_t i = chunks[c].first; i < chunks[c].second; ++i) {
+            collect_identifiers(statements[i].get(), names);
+        }
+        for (const auto& name : names) {
+            auto it = declaring_chunk.find(name);
+            if (it != declaring_chunk.end() && it->second != c) {
+                state_variables.insert(name);
             }
         }
     }
 
-    if (text_type_is_used && program->use_declarations.end() == std::find_if(program->use_declarations.begin(), program->use_declarations.end(), [](const auto& u){ return u->header_name == "string"; })) {
-         output_stream << "#include <string> // Auto-included for text type or string operations\n";
+    for (const auto& stmt : statements) {
+        if (hoisted.count(stmt.get())) {
+            visit(static_cast<const VariableDeclarationNode*>(stmt.get()), "static ");
+        }
     }
+    *out << "\n";
 
+    *out << "struct HsState { // Variables shared between chunks\n";
+    for (const auto& stmt : statements) {
+        auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt.get());
+        if (var_decl && state_variables.count(var_decl->identifier_name)) {
+            *out << "    " << hscript_type_to_cpp_type(var_decl->var_type) << " " << variable_name(var_decl->identifier_name) << "{};\n";
+        }
+    }
+    *out << "};\n\n";
 
-    if (says_is_used) {
-        if (!iostream_included) {
-            output_stream << "#include <iostream> // Auto-included for 'says'\n";
-            iostream_included = true; // Mark it as included
+    if (!units.empty()) {
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            *out << "void hs_chunk" << std::to_string(c) << "(HsState& hs_state_);\n";
         }
-        // Always include iomanip and string for says if iostream is involved, for boolalpha and to_string
-        // Check if already included by a 'use' directive
-        if (program->use_declarations.end() == std::find_if(program->use_declarations.begin(), program->use_declarations.end(), [](const auto& u){ return u->header_name == "iomanip"; })) {
-            output_stream << "#include <iomanip>  // For std::boolalpha with 'says'\n";
+        *out << "\n";
+    }
+
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (!units.empty()) {
+            out = units[chunk_unit[c]];
         }
-        if (program->use_declarations.end() == std::find_if(program->use_declarations.begin(), program->use_declarations.end(), [](const auto& u){ return u->header_name == "string"; })) {
-             // Check if already included above for text_type_is_used
-            bool string_already_auto_included = text_type_is_used && (program->use_declarations.end() == std::find_if(program->use_declarations.begin(), program->use_declarations.end(), [](const auto& u){ return u->header_name == "string"; }));
-            if (!string_already_auto_included) {
-                 output_stream << "#include <string>   // For std::to_string with 'says'\n";
+        *out << (units.empty() ? "static void hs_chunk" : "void hs_chunk") << std::to_string(c) << "(HsState& hs_state_) {\n";
+        *out << "    (void)hs_state_;\n";
+        for (size_t i = chunks[c].first; i < chunks[c].second; ++i) {
+            if (!hoisted.count(statements[i].get())) {
+                generate_top_level_statement(statements[i].get());
             }
         }
-        output_stream << "\n";
+        *out << "}\n\n";
+    }
+
+    if (!units.empty()) {
+        out = units[0];
     }
 
+    *out << "int main() {\n";
+    if (says_is_used) {
+        *out << "    hs_setup_stdout();\n";
+    }
+    *out << "    HsState hs_state_;\n";
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        *out << "    hs_chunk" << std::to_string(c) << "(hs_state_);\n";
+    }
+    *out << "    return 0;\n";
+    *out << "}\n";
+}
 
-    output_stream << "int main() {\n";
-    if (iostream_included) { // Check if iostream was included either by 'use' or by 'says' auto-include
-        output_stream << "    std::cout << std::boolalpha; // Print booleans as true/false\n";
+size_t CodeGenerator::count_statements(const StatementNode* stmt) {
+    if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        return 1 + count_statements(if_stmt->then_branch.get()) + (if_stmt->else_branch ? count_statements(if_stmt->else_branch.get()) : 0);
+    }
+    if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        size_t count = 0;
+        for (const auto& s : block_stmt->statements) {
+            count += count_statements(s.get());
+        }
+        return count;
     }
+    return 1;
+}
 
-    for (const auto& stmt : program->statements) {
-        output_stream << "    "; // Indentation
-        visit(stmt.get()); // visit methods for VariableDeclarationNode, SaysStatementNode, etc.
+void CodeGenerator::collect_identifiers(const StatementNode* stmt, std::unordered_set<std::string>& names) {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        collect_identifiers(var_decl->expression.get(), names);
+    } else if (auto says_node = dynamic_cast<const SaysStatementNode*>(stmt)) {
+        collect_identifiers(says_node->expression.get(), names);
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        collect_identifiers(if_stmt->condition.get(), names);
+        collect_identifiers(if_stmt->then_branch.get(), names);
+        if (if_stmt->else_branch) {
+            collect_identifiers(if_stmt->else_branch.get(), names);
+        }
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            collect_identifiers(s.get(), names);
+        }
+    } else if (auto assignment = dynamic_cast<const AssignmentNode*>(stmt)) {
+        names.insert(assignment->identifier_name);
+        collect_identifiers(assignment->expression.get(), names);
+    }
+}
+
+void CodeGenerator::collect_identifiers(const ExprNode* expr, std::unordered_set<std::string>& names) {
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        collect_identifiers(bin_op->right.get(), names);
+        expr = bin_op->left.get();
     }
+    if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        names.insert(ident->name);
+    }
+}
 
-    output_stream << "    return 0;\n";
-    output_stream << "}\n";
+std::string CodeGenerator::variable_reference(const std::string& name) const {
+    return state_variables.count(name) ? "hs_state_." + variable_name(name) : variable_name(name);
+}
+
+void CodeGenerator::scan_features(const StatementNode* stmt, bool& says_is_used, bool& text_type_is_used, bool& text_concat_is_used) {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        if (var_decl->var_type == HScriptType::TEXT ||
+            (var_decl->expression && var_decl->expression->expr_type == HScriptType::TEXT) ) {
+            text_type_is_used = true;
+        }
+        text_concat_is_used = text_concat_is_used || contains_text_concat(var_decl->expression.get());
+        literal_pool.collect(var_decl->expression.get());
+    } else if (auto says_node = dynamic_cast<const SaysStatementNode*>(stmt)) {
+        says_is_used = true;
+        if (says_node->expression && says_node->expression->expr_type == HScriptType::TEXT) {
+            text_type_is_used = true;
+        }
+        text_concat_is_used = text_concat_is_used || contains_text_concat(says_node->expression.get());
+        literal_pool.collect(says_node->expression.get());
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        text_concat_is_used = text_concat_is_used || contains_text_concat(if_stmt->condition.get());
+        literal_pool.collect(if_stmt->condition.get());
+        scan_features(if_stmt->then_branch.get(), says_is_used, text_type_is_used, text_concat_is_used);
+        if (if_stmt->else_branch) {
+            scan_features(if_stmt->else_branch.get(), says_is_used, text_type_is_used, text_concat_is_used);
+        }
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            scan_features(s.get(), says_is_used, text_type_is_used, text_concat_is_used);
+        }
+    } else if (auto assignment = dynamic_cast<const AssignmentNode*>(stmt)) {
+        // Mutation analysis: only variables that are never assigned are declared const
+        assigned_variables.insert(assignment->identifier_name);
+    }
+}
+
+bool CodeGenerator::is_constant_expression(const ExprNode* expr) const {
+    // Literals and constexpr variables combined by anything but text concatenation
+    // (hs::TextBuilder allocates, so it is not usable in a constant expression)
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        if (is_text_concat(bin_op) || !is_constant_expression(bin_op->right.get())) return false;
+        expr = bin_op->left.get();
+    }
+    if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        return constexpr_variables.count(ident->name) != 0;
+    }
+    return dynamic_cast<const IntegerLiteralNode*>(expr) || dynamic_cast<const DoubleLiteralNode*>(expr) ||
+           dynamic_cast<const StringLiteralNode*>(expr) || dynamic_cast<const BooleanLiteralNode*>(expr);
+}
+
+bool CodeGenerator::contains_text_concat(const ExprNode* expr) {
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        if (is_text_concat(bin_op) || contains_text_concat(bin_op->right.get())) return true;
+        expr = bin_op->left.get();
+    }
+    return false;
+}
+
+void CodeGenerator::generate_literal_pool() {
+    // Each distinct text literal is emitted once; uses refer to it by name
+    const std::vector<const std::string*>& literals = literal_pool.literals();
+    for (size_t id = 0; id < literals.size(); ++id) {
+        *out << "static constexpr std::string_view hs_lit" << std::to_string(id) << " = ";
+        emit_string_literal(*out, *literals[id]);
+        *out << ";\n";
+    }
+    if (!literal_pool.empty()) {
+        *out << "\n";
+    }
+}
+
+void CodeGenerator::generate_runtime(Emitter* implementation) {
+    if (options.link_runtime) {
+        *out << "#include \"humanscript_runtime.h\" // Linked against the humanscript_runtime library\n\n";
+        return;
+    }
+    if (implementation) {
+        // Declarations in every unit, definitions in one
+        std::string_view runtime(HUMANSCRIPT_RUNTIME_SOURCE);
+        *out << "// --- HumanScript runtime (runtime/humanscript_runtime.h) ---\n";
+        *out << runtime.substr(0, HUMANSCRIPT_RUNTIME_HEADER_SIZE);
+        *out << "// --- End of HumanScript runtime ---\n\n";
+        *implementation << "// --- HumanScript runtime (runtime/humanscript_runtime.cpp) ---\n";
+        *implementation << runtime.substr(HUMANSCRIPT_RUNTIME_HEADER_SIZE);
+        *implementation << "// --- End of HumanScript runtime ---\n\n";
+        return;
+    }
+    *out << "// --- HumanScript runtime (runtime/humanscript_runtime.h and .cpp) ---\n";
+    *out << HUMANSCRIPT_RUNTIME_SOURCE;
+    *out << "// --- End of HumanScript runtime ---\n\n";
+}
+
+void CodeGenerator::generate_says_output_declarations(const char* storage) {
+    // 'says' ends lines with '\n' instead of std::endl; whether a line is flushed is
+    // decided here once
+    if (options.runtime == RuntimeKind::MINIMAL) {
+        *out << "#include <csignal>\n";
+    }
+    *out << "#include <cstdlib>\n";
+    *out << "#include <exception>\n";
+    if (options.says_buffering == SaysBuffering::AUTO) {
+        *out << "#ifdef _WIN32\n";
+        *out << "#include <io.h>\n";
+        *out << "#define HS_STDOUT_IS_TTY() (_isatty(1) != 0)\n";
+        *out << "#else\n";
+        *out << "#include <unistd.h>\n";
+        *out << "#define HS_STDOUT_IS_TTY() (isatty(1) != 0)\n";
+        *out << "#endif\n";
+    }
+    *out << "\n";
+    if (options.says_buffering == SaysBuffering::AUTO) {
+        *out << storage << " bool hs_flush_lines = false; // Set to true when stdout is a terminal\n";
+    }
+}
 
-    return output_stream.str();
+void CodeGenerator::generate_says_output_setup() {
+    // Output goes through a large buffer, which is flushed at exit and on std::terminate.
+    // Only the minimal runtime's buffer is drained with nothing but write(2), so only it is
+    // also flushed on SIGINT/SIGTERM; std::cout.flush() is not async-signal-safe.
+    bool minimal = options.runtime == RuntimeKind::MINIMAL;
+    if (minimal) {
+        *out << "static void hs_flush_stdout() { hs::standard_output.flush(); } // write(2) buffer from the runtime\n";
+        *out << "static void hs_flush_and_reraise(int sig) { hs_flush_stdout(); std::signal(sig, SIG_DFL); std::raise(sig); }\n";
+    } else {
+        *out << "static char hs_stdout_buffer[1 << 16];\n";
+        *out << "static void hs_flush_stdout() { std::cout.flush(); }\n";
+    }
+    *out << "static void hs_setup_stdout() {\n";
+    if (!minimal) {
+        *out << "    std::ios::sync_with_stdio(false);\n";
+        *out << "    std::cout.rdbuf()->pubsetbuf(hs_stdout_buffer, sizeof hs_stdout_buffer);\n";
+    }
+    if (options.says_buffering == SaysBuffering::AUTO) {
+        *out << "    hs_flush_lines = HS_STDOUT_IS_TTY();\n";
+    }
+    *out << "    std::atexit(hs_flush_stdout);\n";
+    *out << "    std::set_terminate([] { hs_flush_stdout(); std::abort(); });\n";
+    if (minimal) {
+        *out << "    std::signal(SIGINT, hs_flush_and_reraise);\n";
+        *out << "    std::signal(SIGTERM, hs_flush_and_reraise);\n";
+    }
+    *out << "}\n\n";
 }
 
 // --- Statement Visitors ---
@@ -124,13 +501,43 @@ void CodeGenerator::visit(const StatementNode* stmt) {
     }
 }
 
-void CodeGenerator::visit(const VariableDeclarationNode* stmt) {
+void CodeGenerator::visit(const VariableDeclarationNode* stmt, const char* storage) {
     std::string cpp_type = hscript_type_to_cpp_type(stmt->var_type);
-    output_stream << cpp_type << " " << stmt->identifier_name << " = ";
+    bool is_constant = is_constant_expression(stmt->expression.get());
+    if (state_variables.count(stmt->identifier_name)) {
+        // Declared as a member of HsState in chunked mode; this initializes it
+        cpp_type.clear();
+    } else if (assigned_variables.count(stmt->identifier_name) == 0) {
+        if (is_constant) {
+            // Constant text needs no std::string at all: it is a view of a pooled literal
+            constexpr_variables.insert(stmt->identifier_name);
+            cpp_type = "constexpr " + (stmt->var_type == HScriptType::TEXT ? std::string("std::string_view") : cpp_type);
+        } else {
+            cpp_type = "const " + cpp_type;
+        }
+    }
+    if (!cpp_type.empty()) {
+        *out << storage << cpp_type << " ";
+    }
+    *out << variable_reference(stmt->identifier_name) << " = ";
     // The expression's generated code should be compatible due to semantic analysis.
     // For numeric types, C++ handles implicit conversion (e.g., int to long long, int/ll to double).
-    output_stream << generate_cpp_for_expression(stmt->expression.get(), stmt->var_type);
-    output_stream << ";\n";
+    if (stmt->var_type == HScriptType::TEXT && is_constant && constexpr_variables.count(stmt->identifier_name) == 0) {
+        // Constant text (pooled literals, constexpr text variables) is a string_view,
+        // which only converts to std::string explicitly
+        *out << "std::string(";
+        generate_cpp_for_expression(stmt->expression.get());
+        *out << ")";
+    } else if (stmt->var_type == HScriptType::NUMBER && stmt->expression->expr_type == HScriptType::LNUMBER) {
+        // A widened initializer is narrowed back to int on store; RangeAnalyzer has already
+        // reported it if it may not fit, so the cast keeps g++ from warning a second time
+        *out << "static_cast<int>(";
+        generate_cpp_for_expression(stmt->expression.get());
+        *out << ")";
+    } else {
+        generate_cpp_for_expression(stmt->expression.get());
+    }
+    *out << ";\n";
 }
 
 void CodeGenerator::visit(const SaysStatementNode* stmt) {
@@ -140,28 +547,25 @@ void CodeGenerator::visit(const SaysStatementNode* stmt) {
         // For simplicity, assume pre-scan is correct.
         // Or throw: throw std::runtime_error("CodeGenerator Error: <iostream> not included for 'says'.");
     }
-    output_stream << "std::cout << (";
-    HScriptType expr_h_type = stmt->expression->expr_type;
-    std::string expr_code = generate_cpp_for_expression(stmt->expression.get());
-
-    if (expr_h_type == HScriptType::TEXT) {
-        output_stream << expr_code;
-    } else if (expr_h_type == HScriptType::NUMBER || expr_h_type == HScriptType::LNUMBER || expr_h_type == HScriptType::RIEL || expr_h_type == HScriptType::LOGIC) {
-        output_stream << expr_code;
-    } else {
-        // This path should ideally not be taken if semantic analysis restricts 'says' or if
-        // binary op '+' with string already converted other types to string for concatenation.
-        // However, as a fallback for direct printing of a non-string/non-numeric type:
-        output_stream << "std::to_string(" << expr_code << ")";
+    // hs::say formats numbers with std::to_chars and logic as true/false, bypassing
+    // the locale-aware operator<<
+    const char* stdout_object = options.runtime == RuntimeKind::MINIMAL ? "hs::standard_output" : "std::cout";
+    *out << "hs::say(" << stdout_object << ", ";
+    generate_cpp_for_expression(stmt->expression.get());
+    *out << ");";
+    if (options.says_buffering == SaysBuffering::LINE) {
+        *out << " " << stdout_object << ".flush();";
+    } else if (options.says_buffering == SaysBuffering::AUTO) {
+        *out << " if (hs_flush_lines) " << stdout_object << ".flush();";
     }
-    output_stream << ") << std::endl;\n";
+    *out << "\n";
 }
 
 void CodeGenerator::visit(const IfStatementNode* stmt) {
     // Generate condition with parentheses for clarity
-    output_stream << "if (";
-    output_stream << generate_cpp_for_expression(stmt->condition.get(), HScriptType::LOGIC);
-    output_stream << ") ";
+    *out << "if (";
+    generate_cpp_for_expression(stmt->condition.get());
+    *out << ") ";
     
     // For the then branch
     if (dynamic_cast<const BlockStatementNode*>(stmt->then_branch.get())) {
@@ -169,56 +573,57 @@ void CodeGenerator::visit(const IfStatementNode* stmt) {
         visit(stmt->then_branch.get());
     } else {
         // If it's a single statement, wrap it in braces for consistency
-        output_stream << "{\n        ";
+        *out << "{\n        ";
         visit(stmt->then_branch.get());
-        output_stream << "    }";
+        *out << "    }";
     }
     
     // For the else branch if it exists
     if (stmt->else_branch) {
-        output_stream << " else ";
+        *out << " else ";
         if (dynamic_cast<const BlockStatementNode*>(stmt->else_branch.get())) {
             // If it's already a block, just visit it
             visit(stmt->else_branch.get());
         } else {
             // If it's a single statement, wrap it in braces for consistency
-            output_stream << "{\n        ";
+            *out << "{\n        ";
             visit(stmt->else_branch.get());
-            output_stream << "    }";
+            *out << "    }";
         }
     }
     
-    output_stream << "\n";
+    *out << "\n";
 }
 
 void CodeGenerator::visit(const BlockStatementNode* stmt) {
-    output_stream << "{\n";
+    *out << "{\n";
     
     // Visit each statement in the block with increased indentation
     for (const auto& s : stmt->statements) {
-        output_stream << "        "; // Extra indentation for block statements
+        *out << "        "; // Extra indentation for block statements
         visit(s.get());
     }
     
-    output_stream << "    }";
+    *out << "    }";
 }
 
 // --- Expression Code Generation Helper ---
-std::string CodeGenerator::generate_cpp_for_expression(const ExprNode* expr, HScriptType expected_context_type) {
-    // expected_context_type can be used for explicit casts if needed, but C++ implicit conversions handle many cases.
+// Every expression node appends its code to the emitter exactly once; nothing is built
+// as an intermediate string, so emitting an N-term expression costs O(N).
+void CodeGenerator::generate_cpp_for_expression(const ExprNode* expr) {
     // This function dispatches to the specific generate_expr_code methods.
     if (auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr)) {
-        return generate_expr_code(int_lit);
+        generate_expr_code(int_lit);
     } else if (auto dbl_lit = dynamic_cast<const DoubleLiteralNode*>(expr)) {
-        return generate_expr_code(dbl_lit);
+        generate_expr_code(dbl_lit);
     } else if (auto str_lit = dynamic_cast<const StringLiteralNode*>(expr)) {
-        return generate_expr_code(str_lit);
+        generate_expr_code(str_lit);
     } else if (auto bool_lit = dynamic_cast<const BooleanLiteralNode*>(expr)) {
-        return generate_expr_code(bool_lit);
+        generate_expr_code(bool_lit);
     } else if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
-        return generate_expr_code(ident);
+        generate_expr_code(ident);
     } else if (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
-        return generate_expr_code(bin_op);
+        generate_expr_code(bin_op);
     } else {
         throw std::runtime_error("CodeGenerator Error: Unknown expression node type for expression code generation.");
     }
@@ -226,52 +631,43 @@ std::string CodeGenerator::generate_cpp_for_expression(const ExprNode* expr, HSc
 
 
 // --- Specific Expression Node Code Generators ---
-std::string CodeGenerator::generate_expr_code(const IntegerLiteralNode* expr) {
-    return std::to_string(expr->value) + "LL"; // Suffix with LL for long long literals in C++
-                                              // C++ will implicitly convert to int if assigned to int.
+void CodeGenerator::generate_expr_code(const IntegerLiteralNode* expr) {
+    *out << std::to_string(expr->value);
+    // Literals that fit in int (see RangeAnalyzer) are emitted unsuffixed so int arithmetic stays int
+    if (expr->expr_type != HScriptType::NUMBER) {
+        *out << "LL"; // Suffix with LL for long long literals in C++
+    }
 }
 
-std::string CodeGenerator::generate_expr_code(const DoubleLiteralNode* expr) {
-    std::string s = std::to_string(expr->value);
+void CodeGenerator::generate_expr_code(const DoubleLiteralNode* expr) {
+    // Shortest round-trip form, so the literal in the C++ source is exactly the parsed value
+    hs::Formatted formatted = hs::format(expr->value);
+    std::string_view s = formatted.view();
+    *out << s;
     // Ensure it has a decimal point to be treated as double if it's like "1.0" -> "1"
-    if (s.find('.') == std::string::npos && s.find('e') == std::string::npos && s.find('E') == std::string::npos) {
-        s += ".0";
-    }
-    return s;
-}
-
-std::string CodeGenerator::generate_expr_code(const StringLiteralNode* expr) {
-    // Need to escape characters for C++ string literal if they weren't already
-    // For now, assume lexer handled basic escapes like \", \\, \n, \t correctly for storage,
-    // and we just need to wrap in C++ quotes.
-    std::string cpp_str = "\"";
-    for (char c : expr->value) {
-        switch (c) {
-            case '"': cpp_str += "\\\""; break;
-            case '\\': cpp_str += "\\\\"; break;
-            case '\n': cpp_str += "\\n"; break;
-            case '\r': cpp_str += "\\r"; break;
-            case '\t': cpp_str += "\\t"; break;
-            // Add other escapes if necessary
-            default: cpp_str += c; break;
-        }
+    if (s.find('.') == std::string_view::npos && s.find('e') == std::string_view::npos) {
+        *out << ".0";
     }
-    cpp_str += "\"";
-    return cpp_str;
 }
 
-std::string CodeGenerator::generate_expr_code(const BooleanLiteralNode* expr) {
-    return expr->value ? "true" : "false";
+void CodeGenerator::generate_expr_code(const StringLiteralNode* expr) {
+    std::optional<size_t> id = literal_pool.find(expr->value);
+    if (!id) {
+        throw std::runtime_error("CodeGenerator Error: Text literal missing from the literal pool.");
+    }
+    *out << "hs_lit" << std::to_string(*id);
+}
+
+void CodeGenerator::generate_expr_code(const BooleanLiteralNode* expr) {
+    *out << (expr->value ? "true" : "false");
 }
 
-std::string CodeGenerator::generate_expr_code(const IdentifierNode* expr) {
-    return expr->name; // Assumes variable name is valid C++ identifier
+void CodeGenerator::generate_expr_code(const IdentifierNode* expr) {
+    *out << variable_reference(expr->name);
 }
 
-std::string CodeGenerator::generate_expr_code(const BinaryOpNode* expr) {
-    std::string left_cpp = generate_cpp_for_expression(expr->left.get());
-    std::string right_cpp = generate_cpp_for_expression(expr->right.get());
-    std::string op_cpp;
+BinaryOpPieces CodeGenerator::binary_op_pieces(const BinaryOpNode* expr) {
+    std::string left_open, left_close, op_cpp;
 
     HScriptType expr_result_type = expr->expr_type; // Overall type of the binary operation
     HScriptType left_h_type = expr->left->expr_type;
@@ -279,13 +675,11 @@ std::string CodeGenerator::generate_expr_code(const BinaryOpNode* expr) {
 
     switch (expr->op_token.type) {
         case TokenType::PLUS:
-            if (expr_result_type == HScriptType::TEXT) {
-                if (left_h_type != HScriptType::TEXT) {
-                    left_cpp = "std::to_string(" + left_cpp + ")";
-                }
-                if (right_h_type != HScriptType::TEXT) {
-                    right_cpp = "std::to_string(" + right_cpp + ")";
-                }
+            // Text '+' never gets here: whole concatenation chains go through generate_text_concat
+            if (expr_result_type == HScriptType::LNUMBER && left_h_type == HScriptType::NUMBER && right_h_type == HScriptType::NUMBER) {
+                // RangeAnalyzer widened this sum because it may overflow int
+                left_open = "static_cast<long long>(";
+                left_close = ")";
             }
             op_cpp = "+";
             break;
@@ -295,5 +689,59 @@ std::string CodeGenerator::generate_expr_code(const BinaryOpNode* expr) {
         default:
             throw std::runtime_error("CodeGenerator Error: Unsupported binary operator token for C++ code generation: " + expr->op_token.text);
     }
-    return "(" + left_cpp + " " + op_cpp + " " + right_cpp + ")";
-}
\ No newline at end of file
+    return {"(" + left_open, left_close + " " + op_cpp + " ", ")"};
+}
+
+void CodeGenerator::generate_text_concat(const BinaryOpNode* expr) {
+    // The whole flattened chain becomes one hs::TextBuilder: reserve an upper bound on the
+    // final size once, then append every piece (numbers are formatted in place)
+    std::vector<const ExprNode*> pieces;
+    collect_concat_pieces(expr, pieces);
+
+    size_t constant_bound = 0;
+    std::vector<const IdentifierNode*> text_variables;
+    for (const ExprNode* piece : pieces) {
+        if (auto str_lit = dynamic_cast<const StringLiteralNode*>(piece)) {
+            constant_bound += str_lit->value.size();
+        } else if (piece->expr_type == HScriptType::TEXT) {
+            if (auto ident = dynamic_cast<const IdentifierNode*>(piece)) {
+                text_variables.push_back(ident);
+            }
+        } else {
+            constant_bound += formatted_size_bound(piece->expr_type);
+        }
+    }
+
+    *out << "hs::TextBuilder(" << std::to_string(constant_bound);
+    for (const IdentifierNode* ident : text_variables) {
+        *out << " + " << variable_reference(ident->name) << ".size()";
+    }
+    *out << ")";
+    for (const ExprNode* piece : pieces) {
+        auto str_lit = dynamic_cast<const StringLiteralNode*>(piece);
+        if (str_lit && str_lit->value.empty()) continue; // "" + n only needs the conversion
+        *out << ".add(";
+        generate_cpp_for_expression(piece);
+        *out << ")";
+    }
+    *out << ".take()";
+}
+
+size_t CodeGenerator::formatted_size_bound(HScriptType type) {
+    switch (type) {
+        case HScriptType::NUMBER:  return 11; // "-2147483648"
+        case HScriptType::LNUMBER: return 20; // "-9223372036854775808"
+        case HScriptType::LOGIC:   return 5;  // "false"
+        case HScriptType::RIEL:    return hs::max_formatted_size; // Shortest round-trip form
+        default:                   return 0;
+    }
+}
+
+void CodeGenerator::generate_expr_code(const BinaryOpNode* expr) {
+    if (is_text_concat(expr)) {
+        generate_text_concat(expr);
+        return;
+    }
+
+    emit_binary_spine(expr, *out, binary_op_pieces, [this](const ExprNode* operand) { generate_cpp_for_expression(operand); });
+}
@@ -1,37 +1,125 @@
 #pragma once
 #include "ast.h"
+#include "backend_support.h"
 #include <string>
-#include <sstream> // For building the output string
+#include <vector>
+#include <unordered_set>
+#include "emitter.h"
 #include <stdexcept> // For runtime_error
 
+// How the generated program flushes 'says' output
+enum class SaysBuffering {
+    AUTO, // Flush every line when stdout is a terminal, otherwise buffer fully
+    LINE, // Flush after every 'says'
+    FULL  // Flush only when the buffer fills, at exit, on std::terminate and, with the
+          // minimal runtime, on SIGINT/SIGTERM
+};
+
+// What the generated program's 'says' is built on
+enum class RuntimeKind {
+    IOSTREAM, // std::cout
+    MINIMAL   // hs::standard_output, a buffer drained with write(2); no <iostream>
+};
+
+struct CodeGeneratorOptions {
+    SaysBuffering says_buffering = SaysBuffering::AUTO;
+    RuntimeKind runtime = RuntimeKind::IOSTREAM;
+    bool link_runtime = false; // Include humanscript_runtime.h instead of embedding the runtime
+    size_t chunk_size = 0; // Max statements per generated function; 0 keeps everything in main()
+    size_t translation_units = 1; // --split-tu: how many units generate_split() spreads the chunks over
+};
+
+// Chunk size of generate_split() when chunk_size is 0
+constexpr size_t DEFAULT_SPLIT_CHUNK_SIZE = 256;
+
+// A program split into translation units that compile independently and link together.
+// 'header' holds everything the units share (includes, runtime declarations, the literal
+// pool, constants, HsState and the chunk prototypes); every unit must see it first, whether
+// by #include or by pasting it in front. units[0] holds main().
+struct SplitProgram {
+    std::string header;
+    std::vector<std::string> units;
+};
+
 class CodeGenerator {
 public:
-    CodeGenerator();
+    explicit CodeGenerator(CodeGeneratorOptions options = {});
+    // Streams the generated C++ to 'emitter'; the caller flushes it
+    void generate(const ProgramNode* program, Emitter& emitter);
+    // Convenience wrapper that collects the generated C++ in memory
     std::string generate(const ProgramNode* program);
+    // Chunked code spread over up to options.translation_units units of similar size (fewer
+    // when there are not enough chunks to go around)
+    SplitProgram generate_split(const ProgramNode* program);
 
 private:
-    std::stringstream output_stream;
+    CodeGeneratorOptions options;
+    Emitter* out = nullptr;
     bool iostream_included = false; // Track if <iostream> has been included
 
+    // Text literals, emitted as hs_lit<N> string_views
+    LiteralPool literal_pool;
+    void generate_literal_pool();
+
+    // Variables that are never assigned are emitted const, or constexpr when the initializer
+    // is a constant expression (see is_constant_expression)
+    std::unordered_set<std::string> assigned_variables;
+    std::unordered_set<std::string> constexpr_variables;
+    bool is_constant_expression(const ExprNode* expr) const;
+
+    // Chunked mode: main() calls hs_chunk<N>(HsState&) functions of bounded size
+    std::unordered_set<std::string> state_variables; // Top-level variables shared between chunks
+    void generate_top_level_statement(const StatementNode* stmt);
+    // With 'units', chunks are external functions defined in the unit they are assigned to
+    // and 'out' only receives what the units share
+    void generate_chunked_main(const ProgramNode* program, bool says_is_used, const std::vector<Emitter*>& units = {});
+    void generate_program(const ProgramNode* program, Emitter& emitter, const std::vector<Emitter*>& units);
+    static size_t count_statements(const StatementNode* stmt);
+    static void collect_identifiers(const StatementNode* stmt, std::unordered_set<std::string>& names);
+    static void collect_identifiers(const ExprNode* expr, std::unordered_set<std::string>& names);
+    std::string variable_reference(const std::string& name) const; // Through hs_state_ when it lives in HsState
+
+    // Pre-scan of statements (including nested ones) to decide what to auto-include
+    void scan_features(const StatementNode* stmt, bool& says_is_used, bool& text_type_is_used, bool& text_concat_is_used);
+    static bool contains_text_concat(const ExprNode* expr);
+
+    // The embedded runtime (hs::say, hs::TextBuilder), emitted before main() when needed.
+    // With 'implementation', only the declarations go to 'out' and the definitions go there.
+    void generate_runtime(Emitter* implementation = nullptr);
+
+    // Buffered stdout setup emitted before main() when 'says' is used: the declarations
+    // every chunk needs ('storage' is "static", or "inline" when they are shared between
+    // units) and the functions main() calls
+    void generate_says_output_declarations(const char* storage);
+    void generate_says_output_setup();
+
     // Helper to get C++ type string from HScriptType
     std::string hscript_type_to_cpp_type(HScriptType type);
 
-    // Helper to generate C++ code for an expression, ensuring it's suitable for context
-    std::string generate_cpp_for_expression(const ExprNode* expr, HScriptType expected_context_type = HScriptType::UNKNOWN);
+    // Helper to append C++ code for an expression to the emitter; C++ implicit conversions
+    // adapt it to the context it is used in
+    void generate_cpp_for_expression(const ExprNode* expr);
 
     // Statement code generation
     void visit(const StatementNode* stmt);
-    void visit(const VariableDeclarationNode* stmt);
+    // 'storage' prefixes the declaration: "static " for constants hoisted out of chunked main()
+    void visit(const VariableDeclarationNode* stmt, const char* storage = "");
     void visit(const SaysStatementNode* stmt);
     void visit(const IfStatementNode* stmt);
     void visit(const BlockStatementNode* stmt);
     // void visit(const AssignmentNode* stmt); // If added later
 
     // Expression code generation (internal, called by generate_cpp_for_expression)
-    std::string generate_expr_code(const IntegerLiteralNode* expr);
-    std::string generate_expr_code(const DoubleLiteralNode* expr);
-    std::string generate_expr_code(const StringLiteralNode* expr);
-    std::string generate_expr_code(const BooleanLiteralNode* expr);
-    std::string generate_expr_code(const IdentifierNode* expr);
-    std::string generate_expr_code(const BinaryOpNode* expr);
+    void generate_expr_code(const IntegerLiteralNode* expr);
+    void generate_expr_code(const DoubleLiteralNode* expr);
+    void generate_expr_code(const StringLiteralNode* expr);
+    void generate_expr_code(const BooleanLiteralNode* expr);
+    void generate_expr_code(const IdentifierNode* expr);
+    void generate_expr_code(const BinaryOpNode* expr);
+
+    static BinaryOpPieces binary_op_pieces(const BinaryOpNode* expr);
+
+    // Text '+' chains are flattened and emitted as a single hs::TextBuilder expression
+    static size_t formatted_size_bound(HScriptType type);
+    void generate_text_concat(const BinaryOpNode* expr);
 };
\ No newline at end of file
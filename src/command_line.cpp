@@ -0,0 +1,160 @@
+#include "command_line.h"
+#include "batch.h"
+#include "job_limiter.h"
+#include "watch.h"
+#include <algorithm>
+#include <charconv>
+#include <thread>
+
+namespace {
+// A whole string of decimal digits that fits in size_t
+bool parse_count(const std::string& text, size_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+}
+
+bool parse_command_line(const std::vector<std::string>& arguments, CommandLine& command_line, std::ostream& err) {
+    DriverOptions& options = command_line.options;
+    CodeGeneratorOptions& codegen_options = options.codegen_options;
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const std::string& arg = arguments[i];
+        if (arg == "-run") {
+            options.run_after_compile = true;
+        } else if (arg == "-v") {
+            options.verbose = true;
+        } else if (arg == "--check") {
+            options.check_only = true;
+        } else if (arg.rfind("--says-buffering=", 0) == 0) {
+            std::string mode = arg.substr(std::string("--says-buffering=").size());
+            if (mode == "line") {
+                codegen_options.says_buffering = SaysBuffering::LINE;
+            } else if (mode == "full") {
+                codegen_options.says_buffering = SaysBuffering::FULL;
+            } else if (mode == "auto") {
+                codegen_options.says_buffering = SaysBuffering::AUTO;
+            } else {
+                err << "Error: Unknown --says-buffering mode '" << mode << "' (expected line, full or auto)" << std::endl;
+                return false;
+            }
+        } else if (arg.rfind("--emit=", 0) == 0) {
+            std::string target = arg.substr(std::string("--emit=").size());
+            if (target == "c") {
+                options.emit_c = true;
+            } else if (target == "cpp") {
+                options.emit_c = false;
+            } else {
+                err << "Error: Unknown --emit target '" << target << "' (expected cpp or c)" << std::endl;
+                return false;
+            }
+        } else if (arg.rfind("--runtime=", 0) == 0) {
+            command_line.cpp_only_option_used = true;
+            std::string runtime = arg.substr(std::string("--runtime=").size());
+            if (runtime == "iostream") {
+                codegen_options.runtime = RuntimeKind::IOSTREAM;
+            } else if (runtime == "minimal") {
+                codegen_options.runtime = RuntimeKind::MINIMAL;
+            } else {
+                err << "Error: Unknown --runtime '" << runtime << "' (expected iostream or minimal)" << std::endl;
+                return false;
+            }
+        } else if (arg.rfind("--chunk-size=", 0) == 0) {
+            command_line.cpp_only_option_used = true;
+            std::string size = arg.substr(std::string("--chunk-size=").size());
+            if (!parse_count(size, codegen_options.chunk_size)) {
+                err << "Error: --chunk-size expects a number of statements, got '" << size << "'" << std::endl;
+                return false;
+            }
+        } else if (arg.rfind("--split-tu=", 0) == 0) {
+            command_line.cpp_only_option_used = true;
+            std::string count = arg.substr(std::string("--split-tu=").size());
+            if (!parse_count(count, codegen_options.translation_units) || codegen_options.translation_units == 0) {
+                err << "Error: --split-tu expects a positive number of translation units, got '" << count << "'" << std::endl;
+                return false;
+            }
+        } else if (arg == "--no-cache") {
+            options.use_executable_cache = false;
+        } else if (arg.rfind("--cxx=", 0) == 0) {
+            options.cxx_override = arg.substr(std::string("--cxx=").size());
+        } else if (arg.rfind("--cc=", 0) == 0) {
+            options.cc_override = arg.substr(std::string("--cc=").size());
+        } else if (arg == "--watch") {
+            command_line.watch = true;
+        } else if (arg == "--server") {
+            command_line.serve = true;
+        } else if (arg == "--no-server") {
+            command_line.use_server = false;
+        } else if (arg.rfind("--socket=", 0) == 0) {
+            command_line.socket_path = arg.substr(std::string("--socket=").size());
+        } else if (arg == "-o_cpp" && i + 1 < arguments.size()) {
+            options.output_cpp_filename = arguments[++i];
+        } else if (arg == "-o_exe" && i + 1 < arguments.size()) {
+            options.output_exe_filename = arguments[++i];
+        } else if (arg.rfind("-j", 0) == 0) {
+            std::string count = arg.size() > 2 ? arg.substr(2) : (i + 1 < arguments.size() ? arguments[++i] : "");
+            if (!parse_count(count, command_line.jobs) || command_line.jobs == 0) {
+                err << "Error: -j expects a positive number of jobs, got '" << count << "'" << std::endl;
+                return false;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-' && arg != "-") {
+            err << "Warning: Unrecognized or misplaced argument '" << arg << "'" << std::endl;
+        } else {
+            command_line.input_arguments.push_back(arg);
+        }
+    }
+    return true;
+}
+
+int run_command_line(const CommandLine& command_line, CompilerSession& session, std::ostream& out, std::ostream& err) {
+    const DriverOptions& options = command_line.options;
+
+    std::vector<std::string> input_filenames;
+    try {
+        input_filenames = expand_response_files(command_line.input_arguments);
+    } catch (const std::exception& e) {
+        err << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (input_filenames.empty()) {
+        err << "Usage: humanscript_compiler <input_file.humanscript>... [@response_file] [-run] [--check] [--watch] [-v] [-j N] [--emit=cpp|c] [--says-buffering=line|full|auto] [--runtime=iostream|minimal] [--chunk-size=N] [--split-tu=N] [--cxx=compiler] [--cc=compiler] [--no-cache] [--server|--no-server] [--socket=path] [-o_cpp output.cpp] [-o_exe output_exe]" << std::endl;
+        return 1;
+    }
+
+    if (options.emit_c && command_line.cpp_only_option_used) {
+        err << "Warning: --runtime, --chunk-size and --split-tu only apply to --emit=cpp; ignoring them." << std::endl;
+    }
+
+    size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t jobs = command_line.jobs == 0 ? hardware_threads : command_line.jobs;
+    if (input_filenames.size() > 1) {
+        if (command_line.watch) {
+            err << "Error: --watch takes a single input file" << std::endl;
+            return 1;
+        }
+        if (!options.output_cpp_filename.empty() || !options.output_exe_filename.empty()) {
+            err << "Error: -o_cpp and -o_exe name a single output; they cannot be used with several input files" << std::endl;
+            return 1;
+        }
+        return compile_batch(input_filenames, options, std::max(jobs, hardware_threads), jobs, session, out, err);
+    }
+
+    // Bounds the parallel compiles of --split-tu
+    JobLimiter job_limiter(jobs);
+    CompileContext context;
+    context.job_limiter = &job_limiter;
+    context.analysis_cache = session.analysis_cache();
+    if (options.run_after_compile && !options.check_only) {
+        try {
+            context.backend = &session.backend(options);
+        } catch (const std::exception& e) {
+            err << "\nCompilation Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (command_line.watch) {
+        return watch_file(input_filenames[0], options, context, out, err);
+    }
+    return compile_file(input_filenames[0], options, context, out, err);
+}
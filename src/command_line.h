@@ -0,0 +1,27 @@
+#pragma once
+#include "driver.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A parsed humanscript_compiler invocation
+struct CommandLine {
+    DriverOptions options;
+    std::vector<std::string> input_arguments; // Inputs and @response files, unexpanded
+    size_t jobs = 0;                          // -j; 0 for one per hardware thread
+    bool cpp_only_option_used = false;        // --runtime, --chunk-size and --split-tu only apply to the C++ backend
+    bool watch = false;                       // --watch: recompile whenever the input changes
+    bool serve = false;                       // --server: become the compile server
+    bool use_server = true;                   // --no-server: never forward to a running server
+    std::string socket_path;                  // --socket=; empty for default_server_socket_path()
+};
+
+// Parses the arguments after the program name. Reports malformed options to 'err' and
+// returns false; unknown options only warn.
+bool parse_command_line(const std::vector<std::string>& arguments, CommandLine& command_line, std::ostream& err);
+
+// Compiles, checks or runs what 'command_line' asks for with the state kept in 'session',
+// writing everything to 'out' and 'err'. Relative paths are resolved against the current
+// directory. Returns the process exit status.
+int run_command_line(const CommandLine& command_line, CompilerSession& session, std::ostream& out, std::ostream& err);
@@ -0,0 +1,288 @@
+#include "common_subexpression_eliminator.h"
+#include "humanscript_runtime.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+CommonSubexpressionEliminator::CommonSubexpressionEliminator(bool verbose, DiagnosticStreams diagnostics) : verbose(verbose), diagnostics(diagnostics) {}
+
+void CommonSubexpressionEliminator::run(ProgramNode* program) {
+    declared_names.clear();
+    assigned_names.clear();
+    next_temporary_id = 0;
+    hoisted_expressions = 0;
+
+    for (const auto& stmt : program->statements) {
+        collect_declared_names(stmt.get());
+    }
+
+    visit_statements(program->statements, {});
+
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Common subexpression elimination hoisted " << hoisted_expressions << " expression(s)" << std::endl;
+    }
+}
+
+void CommonSubexpressionEliminator::collect_declared_names(const StatementNode* stmt) {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        declared_names.insert(var_decl->identifier_name);
+    } else if (auto assignment = dynamic_cast<const AssignmentNode*>(stmt)) {
+        assigned_names.insert(assignment->identifier_name);
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        collect_declared_names(if_stmt->then_branch.get());
+        if (if_stmt->else_branch) {
+            collect_declared_names(if_stmt->else_branch.get());
+        }
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            collect_declared_names(s.get());
+        }
+    }
+}
+
+std::string CommonSubexpressionEliminator::make_temporary_name() {
+    std::string name;
+    do {
+        name = "hs_cse" + std::to_string(next_temporary_id++);
+    } while (declared_names.count(name));
+    declared_names.insert(name);
+    return name;
+}
+
+int CommonSubexpressionEliminator::intern(const std::string& key) {
+    auto it = value_numbers.find(key);
+    if (it != value_numbers.end()) return it->second;
+    int number = static_cast<int>(value_numbers.size());
+    value_numbers.emplace(key, number);
+    return number;
+}
+
+void CommonSubexpressionEliminator::visit_statements(std::vector<std::unique_ptr<StatementNode>>& statements, std::unordered_set<std::string> visible) {
+    // Hoisting the outermost repeated expressions can expose repeated subexpressions in the new temporaries
+    while (hoist_round(statements, visible)) {
+    }
+
+    // Expressions over block-local variables are handled in their own scope
+    for (auto& stmt : statements) {
+        if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt.get())) {
+            visit_statements(block_stmt->statements, visible);
+        } else if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt.get())) {
+            if (auto then_block = dynamic_cast<BlockStatementNode*>(if_stmt->then_branch.get())) {
+                visit_statements(then_block->statements, visible);
+            }
+            if (auto else_block = dynamic_cast<BlockStatementNode*>(if_stmt->else_branch.get())) {
+                visit_statements(else_block->statements, visible);
+            }
+        } else if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt.get())) {
+            visible.insert(var_decl->identifier_name);
+        }
+    }
+}
+
+bool CommonSubexpressionEliminator::hoist_round(std::vector<std::unique_ptr<StatementNode>>& statements, const std::unordered_set<std::string>& visible) {
+    value_numbers.clear();
+    variable_versions.clear();
+    node_info.clear();
+    occurrence_counts.clear();
+
+    std::unordered_set<std::string> scope = visible;
+    for (auto& stmt : statements) {
+        assigned_in_statement.clear();
+        scan(stmt.get(), scope, false);
+    }
+
+    OccurrenceMap exposed;
+    std::vector<int> order; // Value numbers in order of first exposure, for deterministic output
+    for (size_t i = 0; i < statements.size(); ++i) {
+        collect(statements[i].get(), i, false, exposed, order);
+    }
+
+    std::multimap<size_t, std::unique_ptr<StatementNode>> temporaries; // Keyed by insertion index
+    bool reused_variables = false;
+    for (int number : order) {
+        std::vector<Occurrence>& occurrences = exposed[number];
+        // Only a use on every path dominates the ones after it; earlier uses inside a branch
+        // keep computing the expression there and are left to the branch's own pass
+        auto dominating = std::find_if(occurrences.begin(), occurrences.end(),
+                                       [](const Occurrence& occurrence) { return !occurrence.conditional; });
+        if (occurrences.end() - dominating < 2) continue;
+
+        ExprNode* first = dominating->slot->get();
+        HScriptType type = first->expr_type;
+        std::optional<ValueRange> range = first->value_range;
+
+        // A variable initialized with the whole expression and never reassigned already
+        // holds its value; a temporary would only add a copy
+        auto var_decl = dynamic_cast<VariableDeclarationNode*>(statements[dominating->statement_index].get());
+        if (var_decl && &var_decl->expression == dominating->slot && var_decl->var_type == type &&
+            !assigned_names.count(var_decl->identifier_name)) {
+            if (verbose) {
+                *diagnostics.info << "Optimizer Info: Reused variable '" << var_decl->identifier_name << "' for '" << first->to_string()
+                          << "' (used " << occurrences.end() - dominating << " times)" << std::endl;
+            }
+            for (auto occurrence = dominating + 1; occurrence != occurrences.end(); ++occurrence) {
+                auto ident = std::make_unique<IdentifierNode>(var_decl->identifier_name);
+                ident->expr_type = type;
+                ident->value_range = range;
+                *occurrence->slot = std::move(ident);
+            }
+            reused_variables = true;
+            hoisted_expressions++;
+            continue;
+        }
+
+        std::string name = make_temporary_name();
+        if (verbose) {
+            *diagnostics.info << "Optimizer Info: Hoisted '" << first->to_string() << "' (used " << occurrences.end() - dominating
+                      << " times) into temporary '" << name << "'" << std::endl;
+        }
+
+        size_t insert_at = dominating->statement_index;
+        auto declaration = std::make_unique<VariableDeclarationNode>(type, name, std::move(*dominating->slot));
+        for (auto occurrence = dominating; occurrence != occurrences.end(); ++occurrence) {
+            auto ident = std::make_unique<IdentifierNode>(name);
+            ident->expr_type = type;
+            ident->value_range = range;
+            *occurrence->slot = std::move(ident);
+        }
+        temporaries.emplace(insert_at, std::move(declaration));
+        hoisted_expressions++;
+    }
+
+    if (temporaries.empty()) return reused_variables;
+
+    std::vector<std::unique_ptr<StatementNode>> rewritten;
+    rewritten.reserve(statements.size() + temporaries.size());
+    auto next_temporary = temporaries.begin();
+    for (size_t i = 0; i < statements.size(); ++i) {
+        for (; next_temporary != temporaries.end() && next_temporary->first == i; ++next_temporary) {
+            rewritten.push_back(std::move(next_temporary->second));
+        }
+        rewritten.push_back(std::move(statements[i]));
+    }
+    statements = std::move(rewritten);
+    return true;
+}
+
+void CommonSubexpressionEliminator::scan(StatementNode* stmt, std::unordered_set<std::string>& scope, bool nested) {
+    if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt)) {
+        scan(var_decl->expression.get(), scope);
+        // Names declared inside nested statements are not visible where a temporary would be inserted
+        if (!nested) {
+            scope.insert(var_decl->identifier_name);
+        }
+    } else if (auto assignment = dynamic_cast<AssignmentNode*>(stmt)) {
+        scan(assignment->expression.get(), scope);
+        variable_versions[assignment->identifier_name]++;
+        assigned_in_statement.insert(assignment->identifier_name);
+    } else if (auto says_stmt = dynamic_cast<SaysStatementNode*>(stmt)) {
+        scan(says_stmt->expression.get(), scope);
+    } else if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt)) {
+        scan(if_stmt->condition.get(), scope);
+        scan(if_stmt->then_branch.get(), scope, true);
+        if (if_stmt->else_branch) {
+            scan(if_stmt->else_branch.get(), scope, true);
+        }
+    } else if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            scan(s.get(), scope, true);
+        }
+    }
+}
+
+CommonSubexpressionEliminator::NodeInfo CommonSubexpressionEliminator::scan(const ExprNode* expr, const std::unordered_set<std::string>& scope) {
+    NodeInfo info{-1, true};
+    if (auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr)) {
+        info.value_number = intern("i:" + std::to_string(int_lit->value) + ":" + hscript_type_to_string(expr->expr_type));
+    } else if (auto dbl_lit = dynamic_cast<const DoubleLiteralNode*>(expr)) {
+        info.value_number = intern("d:" + std::string(hs::format(dbl_lit->value).view())); // Round-trip form: distinct values get distinct keys
+    } else if (auto str_lit = dynamic_cast<const StringLiteralNode*>(expr)) {
+        info.value_number = intern("s:" + str_lit->value);
+    } else if (auto bool_lit = dynamic_cast<const BooleanLiteralNode*>(expr)) {
+        info.value_number = intern(bool_lit->value ? "b:1" : "b:0");
+    } else if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        auto version = variable_versions.find(ident->name);
+        info.value_number = intern("v:" + ident->name + "#" + std::to_string(version == variable_versions.end() ? 0 : version->second));
+        // A temporary hoisted before this statement would see the value from before the assignment
+        info.hoistable = scope.count(ident->name) && !assigned_in_statement.count(ident->name);
+    } else if (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        return scan(bin_op, scope);
+    }
+    node_info[expr] = info;
+    return info;
+}
+
+CommonSubexpressionEliminator::NodeInfo CommonSubexpressionEliminator::scan(const BinaryOpNode* root, const std::unordered_set<std::string>& scope) {
+    // Number the left spine bottom-up in a loop so long chains don't recurse per term
+    std::vector<const BinaryOpNode*> spine;
+    const ExprNode* node = root;
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(node)) {
+        spine.push_back(bin_op);
+        node = bin_op->left.get();
+    }
+
+    NodeInfo left = scan(spine.back()->left.get(), scope);
+    for (size_t i = spine.size(); i-- > 0;) {
+        const BinaryOpNode* bin_op = spine[i];
+        NodeInfo right = scan(bin_op->right.get(), scope);
+        int l = left.value_number;
+        int r = right.value_number;
+        // '?=' and numeric '+' are commutative; text '+' is not
+        bool commutative = bin_op->op_token.type == TokenType::QUESTION_EQUALS || bin_op->expr_type != HScriptType::TEXT;
+        if (commutative && l > r) std::swap(l, r);
+
+        NodeInfo info;
+        info.value_number = intern("op:" + std::to_string(static_cast<int>(bin_op->op_token.type)) + ":" +
+                                   hscript_type_to_string(bin_op->expr_type) + ":" + std::to_string(l) + ":" + std::to_string(r));
+        info.hoistable = left.hoistable && right.hoistable;
+        if (info.hoistable) {
+            occurrence_counts[info.value_number]++;
+        }
+        node_info[bin_op] = info;
+        left = info;
+    }
+    return left;
+}
+
+void CommonSubexpressionEliminator::collect(StatementNode* stmt, size_t statement_index, bool conditional, OccurrenceMap& exposed, std::vector<int>& order) {
+    if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt)) {
+        collect(var_decl->expression, statement_index, conditional, exposed, order);
+    } else if (auto assignment = dynamic_cast<AssignmentNode*>(stmt)) {
+        collect(assignment->expression, statement_index, conditional, exposed, order);
+    } else if (auto says_stmt = dynamic_cast<SaysStatementNode*>(stmt)) {
+        collect(says_stmt->expression, statement_index, conditional, exposed, order);
+    } else if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt)) {
+        collect(if_stmt->condition, statement_index, conditional, exposed, order);
+        collect(if_stmt->then_branch.get(), statement_index, true, exposed, order);
+        if (if_stmt->else_branch) {
+            collect(if_stmt->else_branch.get(), statement_index, true, exposed, order);
+        }
+    } else if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            collect(s.get(), statement_index, conditional, exposed, order);
+        }
+    }
+}
+
+void CommonSubexpressionEliminator::collect(std::unique_ptr<ExprNode>& root, size_t statement_index, bool conditional, OccurrenceMap& exposed, std::vector<int>& order) {
+    // Descend the left spine until the outermost repeated expression; its subexpressions
+    // are evaluated once inside the temporary
+    std::vector<BinaryOpNode*> passed;
+    std::unique_ptr<ExprNode>* slot = &root;
+    while (auto bin_op = dynamic_cast<BinaryOpNode*>(slot->get())) {
+        const NodeInfo& info = node_info.at(bin_op);
+        if (info.hoistable && occurrence_counts[info.value_number] >= 2) {
+            std::vector<Occurrence>& occurrences = exposed[info.value_number];
+            if (occurrences.empty()) order.push_back(info.value_number);
+            occurrences.push_back({slot, statement_index, conditional});
+            break;
+        }
+        passed.push_back(bin_op);
+        slot = &bin_op->left;
+    }
+
+    // Right operands come after everything on the left, so visit them from the inside out
+    for (size_t i = passed.size(); i-- > 0;) {
+        collect(passed[i]->right, statement_index, conditional, exposed, order);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "ast.h"
+#include "diagnostics.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+// Hash-consing CSE over BinaryOpNode expressions. Every expression gets a value number
+// keyed on its operator and the value numbers of its operands (variables are keyed on
+// name and assignment version, so a reassignment invalidates them). Expressions that
+// occur more than once in a statement list are computed once into a temporary declared
+// before their first unconditional use, and that use and every later one read the
+// temporary instead. When that first use is the whole initializer of a variable that is
+// never reassigned, the later uses read the variable and no temporary is made. Uses
+// inside an if branch before it are left alone, so an expression the program only needs
+// on one path is never computed on every path.
+class CommonSubexpressionEliminator {
+public:
+    explicit CommonSubexpressionEliminator(bool verbose = false, DiagnosticStreams diagnostics = {});
+    void run(ProgramNode* program);
+
+    size_t hoisted_expression_count() const { return hoisted_expressions; }
+
+private:
+    struct NodeInfo {
+        int value_number;
+        bool hoistable; // Every variable it reads is declared in the scope being processed
+    };
+
+    struct Occurrence {
+        std::unique_ptr<ExprNode>* slot;
+        size_t statement_index; // Index of the enclosing statement in the list being processed
+        bool conditional;       // Inside an if branch, so not evaluated on every path
+    };
+    using OccurrenceMap = std::unordered_map<int, std::vector<Occurrence>>;
+
+    bool verbose;
+    DiagnosticStreams diagnostics;
+    std::unordered_map<std::string, int> value_numbers;      // Hash-consing table
+    std::unordered_map<std::string, int> variable_versions;  // Bumped by each assignment
+    std::unordered_map<const ExprNode*, NodeInfo> node_info;
+    std::unordered_map<int, size_t> occurrence_counts;
+    std::unordered_set<std::string> declared_names;
+    std::unordered_set<std::string> assigned_names; // Anywhere in the program
+    std::unordered_set<std::string> assigned_in_statement;
+    size_t next_temporary_id = 0;
+    size_t hoisted_expressions = 0;
+
+    void visit_statements(std::vector<std::unique_ptr<StatementNode>>& statements, std::unordered_set<std::string> visible);
+    bool hoist_round(std::vector<std::unique_ptr<StatementNode>>& statements, const std::unordered_set<std::string>& visible);
+
+    // Pass 1: number every expression and count occurrences of hoistable binary operations
+    void scan(StatementNode* stmt, std::unordered_set<std::string>& scope, bool nested);
+    NodeInfo scan(const ExprNode* expr, const std::unordered_set<std::string>& scope);
+    NodeInfo scan(const BinaryOpNode* expr, const std::unordered_set<std::string>& scope);
+
+    // Pass 2: collect the outermost repeated expressions, top-down
+    void collect(StatementNode* stmt, size_t statement_index, bool conditional, OccurrenceMap& exposed, std::vector<int>& order);
+    void collect(std::unique_ptr<ExprNode>& slot, size_t statement_index, bool conditional, OccurrenceMap& exposed, std::vector<int>& order);
+
+    int intern(const std::string& key);
+    std::string make_temporary_name();
+    void collect_declared_names(const StatementNode* stmt);
+};
@@ -0,0 +1,382 @@
+#include "compile_server.h"
+#include "cache_directory.h"
+#include "command_line.h"
+#include "hash.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string_view>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+std::string default_server_socket_path() {
+    if (const char* path = std::getenv("HUMANSCRIPT_SERVER_SOCKET"); path && *path) {
+        return path;
+    }
+    std::string cache_directory = humanscript_cache_directory();
+    return cache_directory.empty() ? "" : cache_directory + "/server.sock";
+}
+
+#ifndef _WIN32
+
+namespace {
+
+// Every message is a frame: [type:1][payload length:4, little-endian][payload]
+constexpr char REQUEST_FRAME = 'Q'; // Client: compatibility key, cwd, arguments; each NUL-terminated
+constexpr char STDOUT_FRAME = 'O';
+constexpr char STDERR_FRAME = 'E';
+constexpr char EXIT_FRAME = 'X';    // Exit status, 4 bytes little-endian; the last frame
+constexpr char REFUSED_FRAME = 'R'; // The server was built or configured differently
+constexpr char ACCEPTED_FRAME = 'A'; // The server is free to take the request
+constexpr char CONFIRMED_FRAME = 'C'; // Client: still waiting; the server may act on the request from now on
+constexpr uint32_t MAX_FRAME_SIZE = 64u << 20;
+
+// The server answers one request at a time, and connect() succeeds through the listen
+// backlog while it is busy. A client not accepted within this long compiles locally.
+constexpr int ACCEPT_TIMEOUT_MS = 250;
+// How long the server waits for a request or confirmation before moving on to the next client
+constexpr int CLIENT_TIMEOUT_SECONDS = 5;
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t got = recv(fd, data, size, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+std::string encode_uint32(uint32_t value) {
+    std::string bytes(4, '\0');
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    return bytes;
+}
+
+uint32_t decode_uint32(const char* bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+
+// False when nothing arrives on 'fd' within 'timeout_ms'
+bool wait_readable(int fd, int timeout_ms) {
+    pollfd descriptor{fd, POLLIN, 0};
+    for (;;) {
+        int ready = poll(&descriptor, 1, timeout_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        return ready > 0;
+    }
+}
+
+bool send_frame(int fd, char type, std::string_view payload) {
+    std::string header = type + encode_uint32(static_cast<uint32_t>(payload.size()));
+    return write_all(fd, header.data(), header.size()) && write_all(fd, payload.data(), payload.size());
+}
+
+bool receive_frame(int fd, char& type, std::string& payload) {
+    char header[5];
+    if (!read_all(fd, header, sizeof header)) return false;
+    uint32_t size = decode_uint32(header + 1);
+    if (size > MAX_FRAME_SIZE) return false;
+    type = header[0];
+    payload.resize(size);
+    return read_all(fd, payload.data(), size);
+}
+
+// Client and server must agree on this to share work: the same compiler binary and the
+// environment variables that pick toolchains and caches
+std::string compatibility_key() {
+    Fnv1aHash key;
+    char executable[4096];
+    ssize_t length = readlink("/proc/self/exe", executable, sizeof executable);
+    if (length > 0) {
+        std::string path(executable, static_cast<size_t>(length));
+        key.add(path);
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0) {
+            key.add(std::to_string(info.st_mtime)).add(std::to_string(info.st_size));
+        }
+    }
+    for (const char* name : {"PATH", "HOME", "TMPDIR", "XDG_CACHE_HOME", "HUMANSCRIPT_CXX", "HUMANSCRIPT_CC", "HUMANSCRIPT_CACHE_DIR", "HUMANSCRIPT_CACHE_LIMIT_MB"}) {
+        const char* value = std::getenv(name);
+        key.add(value ? value : "").add(value ? "set" : "unset");
+    }
+    return key.hex();
+}
+
+bool fill_address(const std::string& socket_path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof address);
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof address.sun_path) return false;
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return true;
+}
+
+// A connected socket, or -1 when nothing listens on 'socket_path'
+int connect_to_server(const std::string& socket_path) {
+    sockaddr_un address;
+    if (!fill_address(socket_path, address)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof address) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends what is written to it to the client as frames of one type; flushes on std::endl.
+// Once the client has gone away the rest of the output is dropped.
+class FrameStreamBuf : public std::streambuf {
+public:
+    FrameStreamBuf(int fd, char type, std::mutex& mutex, bool& connected) : fd(fd), type(type), mutex(mutex), connected(connected) {}
+    ~FrameStreamBuf() override { send_buffer(); }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            buffer.push_back(traits_type::to_char_type(c));
+            if (buffer.size() >= BUFFER_SIZE) send_buffer();
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        buffer.append(data, static_cast<size_t>(size));
+        if (buffer.size() >= BUFFER_SIZE) send_buffer();
+        return size;
+    }
+    int sync() override {
+        send_buffer();
+        return 0;
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    int fd;
+    char type;
+    std::mutex& mutex;
+    bool& connected;
+    std::string buffer;
+
+    void send_buffer() {
+        if (buffer.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (connected && !send_frame(fd, type, buffer)) connected = false;
+        buffer.clear();
+    }
+};
+
+char listening_path[sizeof(sockaddr_un::sun_path)];
+
+extern "C" void stop_server(int signal_number) {
+    unlink(listening_path);
+    _exit(128 + signal_number);
+}
+
+void serve_connection(int client, CompilerSession& session, const std::string& key, int home_directory) {
+    char type;
+    std::string payload;
+    if (!receive_frame(client, type, payload) || type != REQUEST_FRAME) return;
+
+    std::vector<std::string> fields;
+    for (size_t start = 0, end; (end = payload.find('\0', start)) != std::string::npos; start = end + 1) {
+        fields.push_back(payload.substr(start, end - start));
+    }
+    if (fields.size() < 2 || fields[0] != key) {
+        send_frame(client, REFUSED_FRAME, "");
+        return;
+    }
+    // The client runs the invocation itself unless it hears this in time and confirms, so a
+    // client that gave up while this server was busy is never served a second time
+    if (!send_frame(client, ACCEPTED_FRAME, "")) return;
+    if (!receive_frame(client, type, payload) || type != CONFIRMED_FRAME) return;
+
+    std::mutex mutex;
+    bool connected = true;
+    int status = 1;
+    {
+        FrameStreamBuf out_buffer(client, STDOUT_FRAME, mutex, connected);
+        FrameStreamBuf err_buffer(client, STDERR_FRAME, mutex, connected);
+        std::ostream out(&out_buffer);
+        std::ostream err(&err_buffer);
+        // Like std::cerr, flush pending stdout before every write so merged streams keep their order
+        err.tie(&out);
+        if (chdir(fields[1].c_str()) != 0) {
+            err << "Error: The compile server cannot enter '" << fields[1] << "': " << std::strerror(errno) << std::endl;
+        } else {
+            CommandLine command_line;
+            if (parse_command_line({fields.begin() + 2, fields.end()}, command_line, err)) {
+                status = run_command_line(command_line, session, out, err);
+            }
+        }
+        out.flush();
+        err.flush();
+    }
+    if (fchdir(home_directory) != 0) {
+        std::cerr << "Warning: The compile server could not return to its directory: " << std::strerror(errno) << std::endl;
+    }
+    if (connected) send_frame(client, EXIT_FRAME, encode_uint32(static_cast<uint32_t>(status)));
+}
+
+} // namespace
+
+int run_compile_server(const std::string& socket_path) {
+    sockaddr_un address;
+    if (!fill_address(socket_path, address)) {
+        std::cerr << "Error: Unusable compile server socket path '" << socket_path << "'" << std::endl;
+        return 1;
+    }
+    int existing = connect_to_server(socket_path);
+    if (existing >= 0) {
+        close(existing);
+        std::cerr << "Error: A compile server is already listening on '" << socket_path << "'" << std::endl;
+        return 1;
+    }
+
+    // Whatever is left is the socket of a server that did not shut down cleanly
+    unlink(socket_path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    mode_t previous_umask = umask(077); // Only this user may connect
+    int bound = listener < 0 ? -1 : bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof address);
+    umask(previous_umask);
+    if (bound != 0 || listen(listener, 16) != 0) {
+        std::cerr << "Error: Could not listen on '" << socket_path << "': " << std::strerror(errno) << std::endl;
+        if (listener >= 0) close(listener);
+        return 1;
+    }
+    std::memcpy(listening_path, address.sun_path, sizeof listening_path);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, stop_server);
+    std::signal(SIGTERM, stop_server);
+
+    int home_directory = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (home_directory < 0) {
+        std::cerr << "Error: Could not open the working directory: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    CompilerSession session(true);
+    // Resolve the toolchain and build the precompiled header for plain -run now, not on the
+    // first request
+    DriverOptions default_run;
+    default_run.run_after_compile = true;
+    try {
+        session.backend(default_run).prepare(std::cout, std::cerr);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << "; -run requests will fail until a compiler is available" << std::endl;
+    }
+
+    std::string key = compatibility_key();
+    std::cout << "HumanScript compile server listening on " << socket_path << std::endl;
+    for (;;) {
+        int client = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            unlink(socket_path.c_str());
+            return 1;
+        }
+        // A client that connects and never sends its request must not hold up everyone else
+        timeval timeout{CLIENT_TIMEOUT_SECONDS, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+        serve_connection(client, session, key, home_directory);
+        close(client);
+    }
+}
+
+bool forward_to_compile_server(const std::string& socket_path, const std::vector<std::string>& arguments, int& exit_status) {
+    // The server cannot take part in the jobserver of a make that runs this process
+    if (const char* makeflags = std::getenv("MAKEFLAGS"); makeflags && std::strstr(makeflags, "jobserver")) {
+        return false;
+    }
+    int server = connect_to_server(socket_path);
+    if (server < 0) return false;
+
+    std::string request = compatibility_key() + '\0';
+    char* cwd = getcwd(nullptr, 0);
+    if (!cwd) {
+        close(server);
+        return false;
+    }
+    request += std::string(cwd) + '\0';
+    std::free(cwd);
+    for (const auto& argument : arguments) {
+        request += argument + '\0';
+    }
+
+    char type;
+    std::string payload;
+    bool accepted = send_frame(server, REQUEST_FRAME, request) && wait_readable(server, ACCEPT_TIMEOUT_MS) &&
+                    receive_frame(server, type, payload) && type == ACCEPTED_FRAME && send_frame(server, CONFIRMED_FRAME, "");
+    if (!accepted) {
+        // Refused, busy with another request, or gone before it did anything; compile locally
+        // instead. Closing without confirming tells a busy server not to run it.
+        close(server);
+        return false;
+    }
+    // From here on the server may already have compiled, written files or run the program,
+    // so a lost connection is reported rather than run a second time locally
+    while (receive_frame(server, type, payload)) {
+        if (type == STDOUT_FRAME) {
+            std::cout.write(payload.data(), static_cast<std::streamsize>(payload.size())).flush();
+        } else if (type == STDERR_FRAME) {
+            std::cerr.write(payload.data(), static_cast<std::streamsize>(payload.size())).flush();
+        } else if (type == EXIT_FRAME && payload.size() == 4) {
+            close(server);
+            exit_status = static_cast<int>(decode_uint32(payload.data()));
+            return true;
+        } else {
+            break; // Garbage
+        }
+    }
+    close(server);
+    std::cerr << "\nError: Lost the connection to the compile server" << std::endl;
+    exit_status = 1;
+    return true;
+}
+
+#else
+
+int run_compile_server(const std::string&) {
+    std::cerr << "Error: --server needs Unix domain sockets, which this build does not support" << std::endl;
+    return 1;
+}
+
+bool forward_to_compile_server(const std::string&, const std::vector<std::string>&, int&) {
+    return false;
+}
+
+#endif
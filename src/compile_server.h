@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// A long-lived compiler that answers humanscript_compiler invocations over a Unix domain
+// socket. It keeps what every invocation would otherwise rebuild: the resolved toolchain and
+// precompiled header (in a CompilerSession's Backends), the lexer's keyword table and the
+// analyzed programs of recently compiled sources. Requests run one at a time in the client's
+// working directory; the server's own environment applies. A client the server does not
+// accept promptly, because it is busy with another request, compiles locally.
+
+// $HUMANSCRIPT_SERVER_SOCKET, else <humanscript_cache_directory()>/server.sock; empty when
+// there is no cache directory
+std::string default_server_socket_path();
+
+// --server: listens on 'socket_path' until interrupted. Returns the exit status when it
+// cannot start (e.g. another server already answers there).
+int run_compile_server(const std::string& socket_path);
+
+// The thin client: sends the invocation 'arguments' to the server on 'socket_path' and copies
+// its output to stdout/stderr. Returns false without printing anything when no compatible
+// server accepts the request, so the caller compiles locally; otherwise 'exit_status' is the
+// result, which is 1 with an error printed if the connection is lost after acceptance.
+bool forward_to_compile_server(const std::string& socket_path, const std::vector<std::string>& arguments, int& exit_status);
@@ -0,0 +1,131 @@
+#include "constant_folder.h"
+#include "humanscript_runtime.h"
+#include <limits>
+#include <vector>
+
+std::string constant_value_to_string(const ConstantValue& value) {
+    if (auto str = std::get_if<std::string>(&value)) return "\"" + *str + "\"";
+    if (auto b = std::get_if<bool>(&value)) return *b ? "true" : "false";
+    if (auto d = std::get_if<double>(&value)) return std::string(hs::format(*d).view());
+    return std::to_string(std::get<long long>(value));
+}
+
+ConstantFolder::ConstantFolder() {}
+
+void ConstantFolder::bind(const std::string& name, ConstantValue value) {
+    constants[name] = std::move(value);
+}
+
+bool ConstantFolder::is_constant(const std::string& name) const {
+    return constants.count(name) != 0;
+}
+
+void ConstantFolder::clear() {
+    constants.clear();
+}
+
+std::optional<ConstantValue> ConstantFolder::fold(const ExprNode* expr) const {
+    if (auto int_lit = dynamic_cast<const IntegerLiteralNode*>(expr)) {
+        return ConstantValue(int_lit->value);
+    } else if (auto dbl_lit = dynamic_cast<const DoubleLiteralNode*>(expr)) {
+        return ConstantValue(dbl_lit->value);
+    } else if (auto str_lit = dynamic_cast<const StringLiteralNode*>(expr)) {
+        return ConstantValue(str_lit->value);
+    } else if (auto bool_lit = dynamic_cast<const BooleanLiteralNode*>(expr)) {
+        return ConstantValue(bool_lit->value);
+    } else if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        return fold(ident);
+    } else if (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        return fold(bin_op);
+    }
+    return std::nullopt;
+}
+
+std::optional<ConstantValue> ConstantFolder::fold(const IdentifierNode* expr) const {
+    auto it = constants.find(expr->name);
+    if (it == constants.end()) return std::nullopt;
+    return it->second;
+}
+
+std::string ConstantFolder::to_text(const ConstantValue& value) {
+    if (auto str = std::get_if<std::string>(&value)) return *str;
+    // Same formatting as the runtime's hs::TextBuilder in the generated code
+    if (auto b = std::get_if<bool>(&value)) return std::string(hs::format(*b).view());
+    if (auto d = std::get_if<double>(&value)) return std::string(hs::format(*d).view());
+    return std::string(hs::format(std::get<long long>(value)).view());
+}
+
+std::optional<ConstantValue> ConstantFolder::fold(const BinaryOpNode* root) const {
+    // Fold the left spine iteratively; text results are appended in place so an N-term
+    // concatenation costs O(total length) rather than copying the prefix at every level
+    std::vector<const BinaryOpNode*> spine;
+    const ExprNode* node = root;
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(node)) {
+        spine.push_back(bin_op);
+        node = bin_op->left.get();
+    }
+
+    std::optional<ConstantValue> left = fold(spine.back()->left.get());
+    for (size_t i = spine.size(); i-- > 0 && left;) {
+        std::optional<ConstantValue> right = fold(spine[i]->right.get());
+        if (!right) return std::nullopt;
+        if (!apply(spine[i], *left, *right)) return std::nullopt;
+    }
+    return left;
+}
+
+bool ConstantFolder::apply(const BinaryOpNode* expr, ConstantValue& left, const ConstantValue& right) const {
+    bool left_is_double = std::holds_alternative<double>(left);
+    bool right_is_double = std::holds_alternative<double>(right);
+    bool left_is_int = std::holds_alternative<long long>(left);
+    bool right_is_int = std::holds_alternative<long long>(right);
+    bool numeric = (left_is_double || left_is_int) && (right_is_double || right_is_int);
+
+    auto as_double = [](const ConstantValue& v) {
+        return std::holds_alternative<double>(v) ? std::get<double>(v) : static_cast<double>(std::get<long long>(v));
+    };
+
+    switch (expr->op_token.type) {
+        case TokenType::PLUS:
+            if (expr->expr_type == HScriptType::TEXT) {
+                if (!std::holds_alternative<std::string>(left)) {
+                    left = to_text(left);
+                }
+                std::get<std::string>(left) += to_text(right);
+                return true;
+            }
+            if (!numeric) return false;
+            if (left_is_double || right_is_double) {
+                left = as_double(left) + as_double(right);
+            } else {
+                long long l = std::get<long long>(left);
+                long long r = std::get<long long>(right);
+                // Signed overflow is undefined in the generated C++, so leave it to runtime
+                if ((r > 0 && l > std::numeric_limits<long long>::max() - r) ||
+                    (r < 0 && l < std::numeric_limits<long long>::min() - r)) {
+                    return false;
+                }
+                long long sum = l + r;
+                if (expr->expr_type == HScriptType::NUMBER &&
+                    (sum > std::numeric_limits<int>::max() || sum < std::numeric_limits<int>::min())) {
+                    return false;
+                }
+                left = sum;
+            }
+            return true;
+        case TokenType::QUESTION_EQUALS:
+            if (numeric) {
+                if (left_is_double || right_is_double) {
+                    left = as_double(left) == as_double(right);
+                } else {
+                    left = std::get<long long>(left) == std::get<long long>(right);
+                }
+                return true;
+            }
+            if (left.index() != right.index()) return false;
+            left = left == right;
+            return true;
+        default:
+            return false;
+    }
+}
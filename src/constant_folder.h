@@ -0,0 +1,43 @@
+#pragma once
+#include "ast.h"
+#include <string>
+#include <optional>
+#include <variant>
+#include <unordered_map>
+
+// Compile-time value of an expression. The alternatives mirror the C++ types the
+// generated code computes with: long long for number/lnumber, double for riel,
+// std::string for text and bool for logic.
+using ConstantValue = std::variant<long long, double, std::string, bool>;
+
+// Helper to render a ConstantValue the way HumanScript source would spell it (for diagnostics)
+std::string constant_value_to_string(const ConstantValue& value);
+
+// Evaluates expressions built from literals and variables whose initializers are
+// themselves constant. Folding follows the semantics of the generated C++ exactly,
+// so a folded result can replace the runtime computation.
+class ConstantFolder {
+public:
+    ConstantFolder();
+
+    // Returns the value of 'expr' if it is known at compile time, std::nullopt otherwise.
+    std::optional<ConstantValue> fold(const ExprNode* expr) const;
+
+    // Records that variable 'name' always holds 'value'.
+    void bind(const std::string& name, ConstantValue value);
+    bool is_constant(const std::string& name) const;
+    void clear();
+
+private:
+    std::unordered_map<std::string, ConstantValue> constants;
+
+    std::optional<ConstantValue> fold(const IdentifierNode* expr) const;
+    std::optional<ConstantValue> fold(const BinaryOpNode* expr) const;
+
+    // Combines 'left' and 'right' with the operator of 'expr', storing the result in 'left'.
+    // Returns false when the result is not known at compile time.
+    bool apply(const BinaryOpNode* expr, ConstantValue& left, const ConstantValue& right) const;
+
+    // Text conversion used by '+' with a text operand (matches the runtime's hs::format)
+    static std::string to_text(const ConstantValue& value);
+};
@@ -0,0 +1,90 @@
+#include "dead_branch_eliminator.h"
+#include <iostream>
+#include <limits>
+
+namespace {
+bool fits_in_int(const ConstantValue& value) {
+    auto integer = std::get_if<long long>(&value);
+    return !integer || (*integer >= std::numeric_limits<int>::min() && *integer <= std::numeric_limits<int>::max());
+}
+}
+
+DeadBranchEliminator::DeadBranchEliminator(bool verbose, DiagnosticStreams diagnostics) : verbose(verbose), diagnostics(diagnostics) {}
+
+void DeadBranchEliminator::run(ProgramNode* program) {
+    folder.clear();
+    eliminated_branches = 0;
+
+    visit_statements(program->statements);
+
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Dead-branch elimination removed " << eliminated_branches << " branch(es)" << std::endl;
+    }
+}
+
+void DeadBranchEliminator::visit_statements(std::vector<std::unique_ptr<StatementNode>>& statements) {
+    std::vector<std::unique_ptr<StatementNode>> kept;
+    kept.reserve(statements.size());
+    for (auto& stmt : statements) {
+        if (auto replacement = visit(std::move(stmt))) {
+            kept.push_back(std::move(replacement));
+        }
+    }
+    statements = std::move(kept);
+}
+
+std::unique_ptr<StatementNode> DeadBranchEliminator::visit(std::unique_ptr<StatementNode> stmt) {
+    if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt.get())) {
+        // HumanScript has no reassignment, so a constant initializer makes the variable constant.
+        // A number variable holds its initializer narrowed to int, so one that does not fit is
+        // left to run time like every other int overflow. A riel variable holds an integer
+        // initializer converted to double, which rounds above 2^53.
+        auto value = folder.fold(var_decl->expression.get());
+        if (value && var_decl->var_type == HScriptType::RIEL) {
+            if (auto integer = std::get_if<long long>(&*value)) {
+                value = static_cast<double>(*integer);
+            }
+        }
+        if (value && !(var_decl->var_type == HScriptType::NUMBER && !fits_in_int(*value))) {
+            folder.bind(var_decl->identifier_name, std::move(*value));
+        }
+    } else if (auto block = dynamic_cast<BlockStatementNode*>(stmt.get())) {
+        visit_statements(block->statements);
+    } else if (dynamic_cast<IfStatementNode*>(stmt.get())) {
+        return visit_if(std::unique_ptr<IfStatementNode>(static_cast<IfStatementNode*>(stmt.release())));
+    }
+    return stmt;
+}
+
+std::unique_ptr<StatementNode> DeadBranchEliminator::visit_if(std::unique_ptr<IfStatementNode> stmt) {
+    std::optional<ConstantValue> condition = folder.fold(stmt->condition.get());
+
+    if (!condition || !std::holds_alternative<bool>(*condition)) {
+        // Runtime condition: keep the test, but constant ifs may still hide inside the branches
+        stmt->then_branch = visit(std::move(stmt->then_branch));
+        if (!stmt->then_branch) {
+            stmt->then_branch = std::make_unique<BlockStatementNode>();
+        }
+        if (stmt->else_branch) {
+            stmt->else_branch = visit(std::move(stmt->else_branch));
+        }
+        return stmt;
+    }
+
+    bool taken = std::get<bool>(*condition);
+    bool has_dead_branch = !taken || stmt->else_branch;
+    if (has_dead_branch) {
+        eliminated_branches++;
+    }
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Condition '" << stmt->condition->to_string() << "' is always "
+                  << (taken ? "true" : "false") << "; eliminated "
+                  << (taken ? (stmt->else_branch ? "else branch" : "runtime test") : "then branch") << std::endl;
+    }
+
+    std::unique_ptr<StatementNode> survivor = taken ? std::move(stmt->then_branch) : std::move(stmt->else_branch);
+    if (!survivor) {
+        return nullptr;
+    }
+    return visit(std::move(survivor));
+}
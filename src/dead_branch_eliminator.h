@@ -0,0 +1,28 @@
+#pragma once
+#include "ast.h"
+#include "diagnostics.h"
+#include "constant_folder.h"
+#include <memory>
+#include <vector>
+
+// Replaces 'if' statements whose condition is known at compile time with the branch
+// that is actually taken (or removes them when no branch survives).
+class DeadBranchEliminator {
+public:
+    explicit DeadBranchEliminator(bool verbose = false, DiagnosticStreams diagnostics = {});
+    void run(ProgramNode* program);
+
+    size_t eliminated_branch_count() const { return eliminated_branches; }
+
+private:
+    bool verbose;
+    DiagnosticStreams diagnostics;
+    ConstantFolder folder;
+    size_t eliminated_branches = 0;
+
+    void visit_statements(std::vector<std::unique_ptr<StatementNode>>& statements);
+
+    // Returns the statement that should take the place of 'stmt' (nullptr removes it)
+    std::unique_ptr<StatementNode> visit(std::unique_ptr<StatementNode> stmt);
+    std::unique_ptr<StatementNode> visit_if(std::unique_ptr<IfStatementNode> stmt);
+};
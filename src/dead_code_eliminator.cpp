@@ -0,0 +1,164 @@
+#include "dead_code_eliminator.h"
+#include <iostream>
+
+DeadCodeEliminator::DeadCodeEliminator(bool verbose, DiagnosticStreams diagnostics) : verbose(verbose), diagnostics(diagnostics) {}
+
+void DeadCodeEliminator::run(ProgramNode* program) {
+    removed_variables = 0;
+
+    // Removing a declaration or an empty if can make other variables dead, so iterate to a fixed point
+    bool changed = true;
+    while (changed) {
+        compute_liveness(program);
+        changed = sweep(program->statements);
+    }
+
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Dead-code elimination removed " << removed_variables << " unused variable(s)" << std::endl;
+    }
+}
+
+void DeadCodeEliminator::compute_liveness(const ProgramNode* program) {
+    declarations.clear();
+    live_variables.clear();
+
+    std::vector<std::string> worklist;
+    for (const auto& stmt : program->statements) {
+        collect_declarations_and_roots(stmt.get(), worklist);
+    }
+
+    // Variable names are unique program-wide (see SemanticAnalyzer), so a flat map is enough
+    while (!worklist.empty()) {
+        std::string name = std::move(worklist.back());
+        worklist.pop_back();
+        if (!live_variables.insert(name).second) continue;
+
+        auto it = declarations.find(name);
+        if (it != declarations.end()) {
+            collect_reads(it->second->expression.get(), worklist);
+        }
+    }
+}
+
+void DeadCodeEliminator::collect_declarations_and_roots(const StatementNode* stmt, std::vector<std::string>& worklist) {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        declarations[var_decl->identifier_name] = var_decl;
+        if (!is_pure(var_decl->expression.get())) {
+            // The initializer has to run anyway, so everything it reads stays live
+            worklist.push_back(var_decl->identifier_name);
+        }
+    } else if (auto says_stmt = dynamic_cast<const SaysStatementNode*>(stmt)) {
+        collect_reads(says_stmt->expression.get(), worklist);
+    } else if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        collect_reads(if_stmt->condition.get(), worklist);
+        collect_declarations_and_roots(if_stmt->then_branch.get(), worklist);
+        if (if_stmt->else_branch) {
+            collect_declarations_and_roots(if_stmt->else_branch.get(), worklist);
+        }
+    } else if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            collect_declarations_and_roots(s.get(), worklist);
+        }
+    }
+}
+
+void DeadCodeEliminator::collect_reads(const ExprNode* expr, std::vector<std::string>& out) {
+    // Follow the left spine in a loop; only right operands recurse
+    while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+        collect_reads(bin_op->right.get(), out);
+        expr = bin_op->left.get();
+    }
+    if (auto ident = dynamic_cast<const IdentifierNode*>(expr)) {
+        out.push_back(ident->name);
+    }
+}
+
+bool DeadCodeEliminator::is_pure(const ExprNode* expr) {
+    if (dynamic_cast<const IntegerLiteralNode*>(expr) || dynamic_cast<const DoubleLiteralNode*>(expr) ||
+        dynamic_cast<const StringLiteralNode*>(expr) || dynamic_cast<const BooleanLiteralNode*>(expr) ||
+        dynamic_cast<const IdentifierNode*>(expr)) {
+        return true;
+    }
+    if (dynamic_cast<const BinaryOpNode*>(expr)) {
+        while (auto bin_op = dynamic_cast<const BinaryOpNode*>(expr)) {
+            if (!is_pure(bin_op->right.get())) return false;
+            expr = bin_op->left.get();
+        }
+        return is_pure(expr);
+    }
+    return false; // Unknown expression kinds are assumed to have side effects
+}
+
+bool DeadCodeEliminator::is_removable(const StatementNode* stmt) const {
+    if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt)) {
+        return !live_variables.count(var_decl->identifier_name) && is_pure(var_decl->expression.get());
+    }
+    if (auto block_stmt = dynamic_cast<const BlockStatementNode*>(stmt)) {
+        return block_stmt->statements.empty();
+    }
+    if (auto if_stmt = dynamic_cast<const IfStatementNode*>(stmt)) {
+        return is_removable(if_stmt->then_branch.get()) &&
+               (!if_stmt->else_branch || is_removable(if_stmt->else_branch.get())) &&
+               is_pure(if_stmt->condition.get());
+    }
+    return false;
+}
+
+void DeadCodeEliminator::note_removed(const VariableDeclarationNode* stmt) {
+    removed_variables++;
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Removed unused variable '" << stmt->identifier_name << "'" << std::endl;
+    }
+}
+
+bool DeadCodeEliminator::sweep(std::vector<std::unique_ptr<StatementNode>>& statements) {
+    bool changed = false;
+    std::vector<std::unique_ptr<StatementNode>> kept;
+    kept.reserve(statements.size());
+    for (auto& stmt : statements) {
+        changed |= sweep(stmt.get());
+        if (is_removable(stmt.get())) {
+            if (auto var_decl = dynamic_cast<const VariableDeclarationNode*>(stmt.get())) {
+                note_removed(var_decl);
+            } else if (verbose && dynamic_cast<const IfStatementNode*>(stmt.get())) {
+                *diagnostics.info << "Optimizer Info: Removed if statement without effects" << std::endl;
+            }
+            changed = true;
+            continue;
+        }
+        kept.push_back(std::move(stmt));
+    }
+    statements = std::move(kept);
+    return changed;
+}
+
+bool DeadCodeEliminator::sweep(StatementNode* stmt) {
+    if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt)) {
+        return sweep(block_stmt->statements);
+    }
+    if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt)) {
+        bool changed = false;
+        // A branch that is a lone declaration becomes an empty block rather than disappearing
+        auto then_decl = dynamic_cast<const VariableDeclarationNode*>(if_stmt->then_branch.get());
+        if (then_decl && is_removable(then_decl)) {
+            note_removed(then_decl);
+            if_stmt->then_branch = std::make_unique<BlockStatementNode>();
+            changed = true;
+        } else {
+            changed |= sweep(if_stmt->then_branch.get());
+        }
+        if (if_stmt->else_branch) {
+            if (is_removable(if_stmt->else_branch.get())) {
+                if (auto else_decl = dynamic_cast<const VariableDeclarationNode*>(if_stmt->else_branch.get())) {
+                    note_removed(else_decl);
+                }
+                if_stmt->else_branch = nullptr;
+                changed = true;
+            } else {
+                changed |= sweep(if_stmt->else_branch.get());
+            }
+        }
+        return changed;
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "ast.h"
+#include "diagnostics.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+// Liveness-based removal of variables that are never read. A variable is live when
+// a 'says', an 'if' condition or the initializer of another live variable reads it;
+// declarations of dead variables are dropped when their initializer is pure.
+class DeadCodeEliminator {
+public:
+    explicit DeadCodeEliminator(bool verbose = false, DiagnosticStreams diagnostics = {});
+    void run(ProgramNode* program);
+
+    size_t removed_variable_count() const { return removed_variables; }
+
+private:
+    bool verbose;
+    DiagnosticStreams diagnostics;
+    std::unordered_map<std::string, const VariableDeclarationNode*> declarations;
+    std::unordered_set<std::string> live_variables;
+    size_t removed_variables = 0;
+
+    void collect_declarations_and_roots(const StatementNode* stmt, std::vector<std::string>& worklist);
+    void collect_reads(const ExprNode* expr, std::vector<std::string>& out);
+    void compute_liveness(const ProgramNode* program);
+
+    // Removes dead declarations (and ifs left without effects); returns true if anything changed
+    bool sweep(std::vector<std::unique_ptr<StatementNode>>& statements);
+    bool sweep(StatementNode* stmt);
+    bool is_removable(const StatementNode* stmt) const;
+    void note_removed(const VariableDeclarationNode* stmt);
+
+    static bool is_pure(const ExprNode* expr);
+};
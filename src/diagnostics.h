@@ -0,0 +1,10 @@
+#pragma once
+#include <iostream>
+
+// Where the lexer, parser and passes write their messages: info lines ("Semantic Info: ...")
+// and warnings/errors. Defaults to stdout and stderr; batch compilation gives every file its
+// own buffers so that messages of files compiled concurrently come out in input order.
+struct DiagnosticStreams {
+    std::ostream* info = &std::cout;
+    std::ostream* warnings = &std::cerr;
+};
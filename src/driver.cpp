@@ -0,0 +1,612 @@
+#include "driver.h"
+#include "lexer.h"
+#include "parser.h"
+#include "semantic_analyzer.h"
+#include "range_analyzer.h"
+#include "algebraic_simplifier.h"
+#include "dead_branch_eliminator.h"
+#include "dead_code_eliminator.h"
+#include "common_subexpression_eliminator.h"
+#include "c_backend.h"
+#include "hash.h"
+#include "job_limiter.h"
+#include "memory_file.h"
+#include "precompiled_header.h"
+#include "process.h"
+#include "runtime_source.h"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// True when the humanscript_runtime archive this compiler was built with is still on disk
+bool runtime_library_available() {
+    #if defined(HUMANSCRIPT_RUNTIME_LIBRARY) && !defined(_WIN32)
+    std::ifstream library(HUMANSCRIPT_RUNTIME_LIBRARY);
+    return library.good();
+    #else
+    return false; // cl cannot link a GNU archive; always embed the runtime there
+    #endif
+}
+
+// Holds a JobLimiter slot for its lifetime; a null limiter means no limit
+class JobSlot {
+public:
+    explicit JobSlot(JobLimiter* limiter) : limiter(limiter) {
+        if (limiter) token = limiter->acquire();
+    }
+    ~JobSlot() {
+        if (limiter) limiter->release(token);
+    }
+    JobSlot(const JobSlot&) = delete;
+    JobSlot& operator=(const JobSlot&) = delete;
+
+private:
+    JobLimiter* limiter;
+    int token = JobLimiter::NO_TOKEN;
+};
+
+} // namespace
+
+bool DriverOptions::links_runtime() const {
+    return !emit_c && run_after_compile && output_cpp_filename.empty() && runtime_library_available();
+}
+
+std::unique_ptr<ProgramNode> analyze_source(const std::string& source_code, const DriverOptions& options, DiagnosticStreams diagnostics) {
+    Lexer lexer(source_code, diagnostics);
+    std::vector<Token> tokens = lexer.tokenize();
+
+    Parser parser(tokens, diagnostics);
+    std::unique_ptr<ProgramNode> ast_root = parser.parse_program();
+
+    SemanticAnalyzer semantic_analyzer(diagnostics);
+    semantic_analyzer.analyze(ast_root.get());
+
+    RangeAnalyzer range_analyzer(options.verbose, diagnostics);
+    range_analyzer.analyze(ast_root.get());
+
+    AlgebraicSimplifier algebraic_simplifier(options.verbose, diagnostics);
+    algebraic_simplifier.run(ast_root.get());
+
+    DeadBranchEliminator dead_branch_eliminator(options.verbose, diagnostics);
+    dead_branch_eliminator.run(ast_root.get());
+
+    DeadCodeEliminator dead_code_eliminator(options.verbose, diagnostics);
+    dead_code_eliminator.run(ast_root.get());
+
+    CommonSubexpressionEliminator common_subexpression_eliminator(options.verbose, diagnostics);
+    common_subexpression_eliminator.run(ast_root.get());
+
+    return ast_root;
+}
+
+SplitProgram generate_split_code(const ProgramNode* program, const DriverOptions& options) {
+    CodeGeneratorOptions codegen_options = options.codegen_options;
+    codegen_options.link_runtime = options.links_runtime();
+    CodeGenerator code_generator(codegen_options);
+    return code_generator.generate_split(program);
+}
+
+void generate_code(const ProgramNode* program, const DriverOptions& options, Emitter& emitter) {
+    CodeGeneratorOptions codegen_options = options.codegen_options;
+    codegen_options.link_runtime = options.links_runtime();
+    if (options.emit_c) {
+        CBackend c_backend(codegen_options);
+        c_backend.generate(program, emitter);
+    } else {
+        CodeGenerator code_generator(codegen_options);
+        code_generator.generate(program, emitter);
+    }
+}
+
+Backend::Backend(const DriverOptions& options) : emit_c(options.emit_c), link_runtime(options.links_runtime()), runtime(options.codegen_options.runtime) {
+    toolchain = options.emit_c ? find_toolchain(SourceLanguage::C, options.cc_override) : find_toolchain(SourceLanguage::CPP, options.cxx_override);
+    if (toolchain.is_msvc) {
+        compile_flags = {options.emit_c ? "/TC" : "/EHsc", "/O2"};
+        if (!options.emit_c) compile_flags.push_back("/std:c++17");
+    } else if (options.emit_c) {
+        compile_flags = {"-std=c99", "-O2"};
+    } else {
+        compile_flags = {"-std=c++17", "-O2"};
+        #ifdef HUMANSCRIPT_RUNTIME_LIBRARY
+        if (link_runtime) {
+            compile_flags.push_back("-I" HUMANSCRIPT_RUNTIME_INCLUDE_DIR);
+        }
+        #endif
+    }
+}
+
+std::string Backend::backend_key(const DriverOptions& options) {
+    Fnv1aHash key;
+    key.add(options.emit_c ? "c" : "cpp").add(options.cxx_override).add(options.cc_override).add(options.links_runtime() ? "linked" : "embedded");
+    key.add(options.codegen_options.runtime == RuntimeKind::MINIMAL ? "minimal" : "iostream");
+    return key.hex();
+}
+
+void Backend::prepare(std::ostream& out, std::ostream& err) {
+    if (toolchain.is_msvc || emit_c) return;
+    // The precompiled header must see exactly the flags the program is compiled with
+    std::call_once(precompiled_header_once, [&] {
+        precompiled_header = prepare_precompiled_header(toolchain, compile_flags, link_runtime, runtime, {&out, &err});
+    });
+}
+
+std::vector<std::string> Backend::compile_command(const std::vector<std::string>& source_filenames, const std::string& output_path, bool compile_only, std::ostream& out, std::ostream& err) {
+    std::vector<std::string> command = {toolchain.path};
+    if (toolchain.is_msvc) {
+        command.insert(command.end(), compile_flags.begin(), compile_flags.end());
+        if (source_filenames.size() > 1) {
+            command.push_back("/MP"); // cl compiles the units on several cores itself
+        }
+        command.push_back("/Fe" + output_path);
+        command.insert(command.end(), source_filenames.begin(), source_filenames.end());
+    } else if (emit_c) {
+        command.insert(command.end(), compile_flags.begin(), compile_flags.end());
+        command.insert(command.end(), {"-x", "c", "-"});
+        if (compile_only) command.push_back("-c");
+        command.insert(command.end(), {"-o", output_path});
+    } else {
+        prepare(out, err);
+        command.insert(command.end(), compile_flags.begin(), compile_flags.end());
+        if (!precompiled_header.empty()) {
+            command.insert(command.end(), {"-include", precompiled_header});
+        }
+        command.insert(command.end(), {"-x", "c++", "-"});
+        #ifdef HUMANSCRIPT_RUNTIME_LIBRARY
+        if (link_runtime && !compile_only) {
+            // -x none: the archive after the stdin source is not C++ to compile
+            command.insert(command.end(), {"-x", "none", HUMANSCRIPT_RUNTIME_LIBRARY});
+        }
+        #endif
+        if (compile_only) command.push_back("-c");
+        command.insert(command.end(), {"-o", output_path});
+    }
+    return command;
+}
+
+std::vector<std::string> Backend::link_command(const std::vector<std::string>& object_filenames, const std::string& output_path) const {
+    std::vector<std::string> command = {toolchain.path};
+    command.insert(command.end(), compile_flags.begin(), compile_flags.end());
+    command.insert(command.end(), object_filenames.begin(), object_filenames.end());
+    #ifdef HUMANSCRIPT_RUNTIME_LIBRARY
+    if (link_runtime) {
+        command.push_back(HUMANSCRIPT_RUNTIME_LIBRARY);
+    }
+    #endif
+    command.insert(command.end(), {"-o", output_path});
+    return command;
+}
+
+ProcessResult Backend::build_translation_units(const std::vector<std::string>& translation_units, const std::string& output_path, const std::vector<int>& inherited_fds,
+                                               JobLimiter* job_limiter, std::ostream& out, std::ostream& err) {
+    prepare(out, err); // Before the workers, so its messages come first
+
+    // Unique per process and per call, like ExecutableCache::temporary_path
+    static std::atomic<unsigned> counter{0};
+    std::string name = "humanscript-units-";
+    #ifndef _WIN32
+    name += std::to_string(static_cast<long long>(getpid())) + "-";
+    #endif
+    name += std::to_string(counter++);
+    std::error_code error;
+    fs::path object_directory = fs::temp_directory_path(error) / name;
+    if (error || !fs::create_directories(object_directory, error)) {
+        err << "Error: Could not create a directory for object files: " << error.message() << std::endl;
+        return {};
+    }
+
+    struct UnitBuild {
+        std::string object_filename;
+        std::ostringstream out;
+        std::ostringstream err;
+        ProcessResult result;
+    };
+    std::vector<UnitBuild> builds(translation_units.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < translation_units.size(); ++i) {
+        builds[i].object_filename = (object_directory / ("unit" + std::to_string(i) + ".o")).string();
+        workers.emplace_back([&, i] {
+            UnitBuild& build = builds[i];
+            std::vector<std::string> command = compile_command({}, build.object_filename, true, build.out, build.err);
+            build.out << "Executing: " << command_line_for_display(command) << std::endl;
+            JobSlot slot(job_limiter);
+            build.result = run_process(command, translation_units[i], build.out, build.err);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    ProcessResult result;
+    std::vector<std::string> object_filenames;
+    bool compiled = true;
+    for (auto& build : builds) {
+        out << build.out.str();
+        err << build.err.str();
+        if (compiled && !build.result.succeeded()) {
+            result = build.result;
+            compiled = false;
+        }
+        object_filenames.push_back(build.object_filename);
+    }
+    if (compiled) {
+        std::vector<std::string> command = link_command(object_filenames, output_path);
+        out << "Executing: " << command_line_for_display(command) << std::endl;
+        JobSlot slot(job_limiter);
+        result = run_process(command, "", out, err, inherited_fds);
+    }
+    fs::remove_all(object_directory, error);
+    return result;
+}
+
+int Backend::compile_and_run(const std::vector<std::string>& translation_units, const std::vector<std::string>& source_filenames, const std::string& exe_filename,
+                             const DriverOptions& options, JobLimiter* job_limiter, std::ostream& out, std::ostream& err) {
+    const char* language = emit_c ? "C" : "C++";
+
+    // Only executables nobody asked to keep are cached; cl names its output itself
+    bool use_cache = options.use_executable_cache && options.output_exe_filename.empty() && !toolchain.is_msvc && executable_cache.enabled();
+    std::string cache_key;
+    std::string executable_path = exe_filename;
+    std::unique_ptr<MemoryFile> in_memory_executable;
+    if (use_cache) {
+        // Whatever sits under the key is run without a second look, so the key must not collide
+        Sha256Hash key;
+        for (const auto& unit : translation_units) key.add(unit);
+        key.add(toolchain.path).add(toolchain.version);
+        for (const auto& flag : compile_flags) key.add(flag);
+        if (link_runtime) {
+            key.add(HUMANSCRIPT_RUNTIME_SOURCE); // What the linked archive was built from
+        }
+        cache_key = key.hex();
+        executable_path = executable_cache.lookup(cache_key);
+    }
+
+    if (use_cache && !executable_path.empty()) {
+        out << "\nUsing cached executable: " << executable_path << std::endl;
+    } else {
+        std::string output_path = use_cache ? executable_cache.temporary_path(cache_key) : exe_filename;
+        // An uncached executable nobody asked to keep is linked into a memfd and never
+        // touches the working directory (falls back to a file where memfd is missing)
+        if (!use_cache && options.output_exe_filename.empty() && !toolchain.is_msvc) {
+            in_memory_executable = std::make_unique<MemoryFile>("humanscript-program");
+            if (in_memory_executable->valid()) {
+                output_path = inherited_fd_path(0);
+            } else {
+                in_memory_executable.reset();
+            }
+        }
+
+        out << "\nCompiling generated " << language << " code";
+        if (translation_units.size() > 1) {
+            out << " (" << translation_units.size() << " translation units)";
+        }
+        out << "..." << std::endl;
+        std::vector<int> inherited_fds;
+        if (in_memory_executable) inherited_fds.push_back(in_memory_executable->descriptor());
+        ProcessResult compile_result;
+        if (translation_units.size() == 1 || toolchain.is_msvc) {
+            std::vector<std::string> command = compile_command(source_filenames, output_path, false, out, err);
+            out << "Executing: " << command_line_for_display(command) << std::endl;
+            JobSlot slot(job_limiter);
+            compile_result = run_process(command, toolchain.is_msvc ? "" : translation_units[0], out, err, inherited_fds);
+        } else {
+            compile_result = build_translation_units(translation_units, output_path, inherited_fds, job_limiter, out, err);
+        }
+
+        if (!compile_result.succeeded()) {
+            err << "Error: " << language << " compilation failed (" << compile_result.describe() << ")" << std::endl;
+            if (use_cache) std::remove(output_path.c_str());
+            return 1;
+        }
+        if (in_memory_executable && (in_memory_executable->empty() || !in_memory_executable->make_executable())) {
+            err << "Error: The compiler did not produce an executable in memory" << std::endl;
+            return 1;
+        }
+        executable_path = use_cache ? executable_cache.insert(cache_key, output_path) : output_path;
+        out << language << " compilation successful. Executable: " << (in_memory_executable ? "(in memory)" : executable_path) << std::endl;
+    }
+
+    out << "\nRunning compiled HumanScript program..." << std::endl;
+    out << "----------------------------------------" << std::endl;
+
+    // Spawned by path, not looked up in PATH, so a bare name needs ./
+    #ifndef _WIN32
+    if (executable_path.find('/') == std::string::npos) {
+        executable_path = "./" + executable_path;
+    }
+    #endif
+
+    ProcessResult run_result;
+    {
+        JobSlot slot(job_limiter);
+        run_result = in_memory_executable
+            ? run_process_from_fd(in_memory_executable->descriptor(), {exe_filename}, "", out, err)
+            : run_process({executable_path}, "", out, err);
+    }
+    out << "----------------------------------------" << std::endl;
+    out << "HumanScript program finished with " << run_result.describe() << std::endl;
+
+    if (!use_cache && !in_memory_executable && options.output_exe_filename.empty()) {
+        std::remove(exe_filename.c_str());
+    }
+    return 0;
+}
+
+std::string AnalysisCache::key(const std::string& source_code, const DriverOptions& options) {
+    // -v is the only option the front end reads. A hit is trusted without comparing the
+    // source, so a collision would compile the wrong program.
+    return Sha256Hash().add(source_code).add(options.verbose ? "verbose" : "quiet").hex();
+}
+
+std::shared_ptr<const AnalysisCache::Entry> AnalysisCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(key);
+    if (found == entries.end()) return nullptr;
+    recency.splice(recency.begin(), recency, found->second.second);
+    return found->second.first;
+}
+
+void AnalysisCache::insert(const std::string& key, std::shared_ptr<const Entry> entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        found->second.first = std::move(entry);
+        recency.splice(recency.begin(), recency, found->second.second);
+        return;
+    }
+    recency.push_front(key);
+    entries.emplace(key, std::make_pair(std::move(entry), recency.begin()));
+    while (entries.size() > capacity) {
+        entries.erase(recency.back());
+        recency.pop_back();
+    }
+}
+
+CompilerSession::CompilerSession(bool cache_analyses) {
+    if (cache_analyses) analyses = std::make_unique<AnalysisCache>();
+}
+
+Backend& CompilerSession::backend(const DriverOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Backend>& backend = backends[Backend::backend_key(options)];
+    if (!backend) {
+        backend = std::make_unique<Backend>(options); // A throw leaves the slot empty for a retry
+    }
+    return *backend;
+}
+
+namespace {
+
+// analyze_source through 'cache' when there is one; a cached program replays the messages
+// its analysis printed
+std::shared_ptr<const ProgramNode> analyze_cached(const std::string& source_code, const DriverOptions& options, AnalysisCache* cache, std::ostream& out, std::ostream& err) {
+    if (!cache) {
+        return analyze_source(source_code, options, {&out, &err});
+    }
+    std::string key = AnalysisCache::key(source_code, options);
+    std::shared_ptr<const AnalysisCache::Entry> entry = cache->find(key);
+    if (!entry) {
+        auto analyzed = std::make_shared<AnalysisCache::Entry>();
+        std::ostringstream info, warnings;
+        try {
+            analyzed->program = analyze_source(source_code, options, {&info, &warnings});
+        } catch (...) {
+            out << info.str();
+            err << warnings.str();
+            throw; // Failed analyses are not cached; the error is reported again next time
+        }
+        analyzed->info = info.str();
+        analyzed->warnings = warnings.str();
+        cache->insert(key, analyzed);
+        entry = analyzed;
+    }
+    out << entry->info;
+    err << entry->warnings;
+    return entry->program;
+}
+
+void write_file(const std::string& filename, std::string_view prefix, const std::string& text) {
+    FileDescriptorSink file(filename);
+    file.write(prefix.data(), prefix.size());
+    file.write(text.data(), text.size());
+    file.close();
+}
+
+// --split-tu: writes the program as <stem>.h plus <stem>_<i>.cpp next to where the single
+// file would have gone and/or compiles the units in parallel; otherwise like compile_file
+int compile_split_program(const ProgramNode* program, const DriverOptions& options, const CompileContext& context, const std::string& cpp_filename,
+                          const std::string& exe_filename, const std::string& base_filename, std::ostream& out, std::ostream& err) {
+    SplitProgram split = generate_split_code(program, options);
+    Backend* backend = context.backend;
+    bool run_after_compile = options.run_after_compile && backend;
+    bool write_source_files = !run_after_compile || !options.output_cpp_filename.empty() || backend->needs_source_file();
+
+    fs::path cpp_path(cpp_filename);
+    std::string stem = (cpp_path.parent_path() / cpp_path.stem()).string();
+    std::string header_filename = stem + ".h";
+    std::vector<std::string> unit_filenames;
+    for (size_t i = 0; i < split.units.size(); ++i) {
+        unit_filenames.push_back(stem + "_" + std::to_string(i) + cpp_path.extension().string());
+    }
+
+    bool source_files_current = false;
+    if (context.previous_code) {
+        std::string combined = split.header;
+        for (const auto& unit : split.units) {
+            combined += '\0' + unit;
+        }
+        source_files_current = *context.previous_code == combined && std::ifstream(header_filename).good();
+        for (const auto& filename : unit_filenames) {
+            source_files_current = source_files_current && std::ifstream(filename).good();
+        }
+        *context.previous_code = std::move(combined);
+    }
+    if (write_source_files && !source_files_current) {
+        write_file(header_filename, "#pragma once\n", split.header);
+        std::string include = "// Generated by HumanScript Compiler\n#include \"" + fs::path(header_filename).filename().string() + "\"\n\n";
+        for (size_t i = 0; i < split.units.size(); ++i) {
+            write_file(unit_filenames[i], include, split.units[i]);
+        }
+    }
+
+    std::string unit_list;
+    for (const auto& filename : unit_filenames) {
+        unit_list += " " + filename;
+    }
+    if (source_files_current) {
+        out << "Generated C++ code unchanged: " << header_filename << unit_list << std::endl;
+    } else if (write_source_files) {
+        out << "Generated C++ code written to: " << header_filename << unit_list << std::endl;
+    } else {
+        size_t size = 0;
+        for (const auto& unit : split.units) {
+            size += split.header.size() + unit.size();
+        }
+        out << "Generated C++ code (" << split.units.size() << " translation units, " << size << " bytes)" << std::endl;
+    }
+
+    if (run_after_compile) {
+        std::vector<std::string> translation_units;
+        for (const auto& unit : split.units) {
+            translation_units.push_back(split.header + unit); // The header, pasted in front
+        }
+        int status = backend->compile_and_run(translation_units, unit_filenames, exe_filename, options, context.job_limiter, out, err);
+        if (write_source_files && options.output_cpp_filename.empty()) {
+            std::remove(header_filename.c_str());
+            for (const auto& filename : unit_filenames) {
+                std::remove(filename.c_str());
+            }
+        }
+        return status;
+    }
+
+    out << "\nTo run the compiled C++ code, use a C++ compiler, e.g.:" << std::endl;
+    out << "  g++ -std=c++17 -O2" << unit_list << " -o " << base_filename << "_executable" << std::endl;
+    out << "  ./" << base_filename << "_executable" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int compile_file(const std::string& input_filename, const DriverOptions& options, const CompileContext& context, std::ostream& out, std::ostream& err) {
+    std::string base_filename = input_filename;
+    size_t dot_pos = base_filename.rfind('.');
+    if (dot_pos != std::string::npos) {
+        base_filename = base_filename.substr(0, dot_pos);
+    }
+
+    // -o_cpp names the generated source for either backend
+    std::string temp_cpp_filename = options.output_cpp_filename.empty() ? base_filename + (options.emit_c ? "_hs_generated.c" : "_hs_generated.cpp") : options.output_cpp_filename;
+    std::string temp_exe_filename = options.output_exe_filename.empty() ? base_filename + "_hs_executable" : options.output_exe_filename;
+    #if defined(_WIN32) || defined(_WIN64)
+    if (options.output_exe_filename.empty() || options.output_exe_filename.rfind(".exe") == std::string::npos) {
+        if (temp_exe_filename.rfind(".exe") == std::string::npos) {
+            temp_exe_filename += ".exe";
+        }
+    }
+    #endif
+
+    std::ifstream input_file_stream(input_filename);
+    if (!input_file_stream.is_open()) {
+        err << "Error: Could not open input file '" << input_filename << "'" << std::endl;
+        return 1;
+    }
+
+    std::stringstream buffer;
+    buffer << input_file_stream.rdbuf();
+    std::string source_code = buffer.str();
+    input_file_stream.close();
+
+    if (source_code.empty() && input_filename != "/dev/null") {
+        err << "Warning: Input file '" << input_filename << "' is empty or could not be read." << std::endl;
+    }
+
+    out << "Compiling HumanScript file: " << input_filename << std::endl;
+
+    try {
+        std::shared_ptr<const ProgramNode> ast_root = analyze_cached(source_code, options, context.analysis_cache, out, err);
+        if (options.check_only) {
+            out << "No errors found in " << input_filename << std::endl;
+            return 0;
+        }
+        if (options.splits_translation_units()) {
+            return compile_split_program(ast_root.get(), options, context, temp_cpp_filename, temp_exe_filename, base_filename, out, err);
+        }
+
+        const char* language = options.emit_c ? "C" : "C++";
+        // -run keeps the code in memory, streams it to the compiler's stdin and hashes it for
+        // the executable cache; a file is only written when the user asked to keep it, when
+        // not running, or for cl, which cannot read source from stdin
+        Backend* backend = context.backend;
+        bool run_after_compile = options.run_after_compile && backend;
+        bool write_source_file = !run_after_compile || !options.output_cpp_filename.empty() || backend->needs_source_file();
+        // --watch compares against the previous build in memory, so the code is not streamed
+        bool keep_in_memory = run_after_compile || context.previous_code;
+        std::string generated_code;
+        {
+            std::unique_ptr<OutputSink> code_sink;
+            if (keep_in_memory) {
+                code_sink = std::make_unique<MemorySink>();
+            } else {
+                code_sink = std::make_unique<FileDescriptorSink>(temp_cpp_filename);
+            }
+            Emitter code_emitter(*code_sink);
+            generate_code(ast_root.get(), options, code_emitter);
+            code_emitter.flush();
+            if (keep_in_memory) {
+                generated_code = static_cast<MemorySink&>(*code_sink).take();
+            } else {
+                static_cast<FileDescriptorSink&>(*code_sink).close();
+            }
+        }
+        // An unchanged file keeps its timestamp, so whatever builds from it stays up to date
+        bool source_file_current = context.previous_code && *context.previous_code == generated_code && std::ifstream(temp_cpp_filename).good();
+        if (context.previous_code) {
+            *context.previous_code = generated_code;
+        }
+        if (keep_in_memory && write_source_file && !source_file_current) {
+            FileDescriptorSink source_file(temp_cpp_filename);
+            source_file.write(generated_code.data(), generated_code.size());
+            source_file.close();
+        }
+        if (source_file_current) {
+            out << "Generated " << language << " code unchanged: " << temp_cpp_filename << std::endl;
+        } else if (write_source_file) {
+            out << "Generated " << language << " code written to: " << temp_cpp_filename << std::endl;
+        } else {
+            out << "Generated " << language << " code (" << generated_code.size() << " bytes)" << std::endl;
+        }
+
+        if (run_after_compile) {
+            std::vector<std::string> translation_units;
+            translation_units.push_back(std::move(generated_code));
+            int status = backend->compile_and_run(translation_units, {temp_cpp_filename}, temp_exe_filename, options, context.job_limiter, out, err);
+            if (write_source_file && options.output_cpp_filename.empty()) {
+                std::remove(temp_cpp_filename.c_str());
+            }
+            return status;
+        }
+
+        out << "\nTo run the compiled " << language << " code, use a " << language << " compiler, e.g.:" << std::endl;
+        if (options.emit_c) {
+            out << "  cc -std=c99 -O2 " << temp_cpp_filename << " -o " << base_filename << "_executable" << std::endl;
+        } else {
+            out << "  g++ -std=c++17 -O2 " << temp_cpp_filename << " -o " << base_filename << "_executable" << std::endl;
+        }
+        out << "  ./" << base_filename << "_executable" << std::endl;
+    } catch (const std::exception& e) {
+        err << "\nCompilation Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
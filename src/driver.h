@@ -0,0 +1,151 @@
+#pragma once
+#include "ast.h"
+#include "code_generator.h"
+#include "diagnostics.h"
+#include "emitter.h"
+#include "executable_cache.h"
+#include "process.h"
+#include "toolchain.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobLimiter;
+
+// Everything the command line says about how to compile a script
+struct DriverOptions {
+    bool run_after_compile = false;
+    bool verbose = false;
+    bool emit_c = false;
+    CodeGeneratorOptions codegen_options;
+    std::string output_cpp_filename; // -o_cpp; empty for <base>_hs_generated.cpp
+    std::string output_exe_filename; // -o_exe; empty for a cached or temporary executable
+    std::string cxx_override;        // --cxx=, else $HUMANSCRIPT_CXX
+    std::string cc_override;         // --cc=, else $HUMANSCRIPT_CC
+    bool use_executable_cache = true;
+    bool check_only = false;         // --check: run the front end for its diagnostics only
+
+    // --split-tu=N with N > 1; the C backend always emits one file
+    bool splits_translation_units() const { return !emit_c && codegen_options.translation_units > 1; }
+
+    // -run links the prebuilt runtime archive instead of compiling the embedded runtime into
+    // every program; a .cpp the user asked to keep stays self-contained
+    bool links_runtime() const;
+};
+
+// Front end: lexes, parses, analyzes and optimizes 'source_code'. Messages go to
+// 'diagnostics'; the first error is thrown as std::runtime_error.
+std::unique_ptr<ProgramNode> analyze_source(const std::string& source_code, const DriverOptions& options, DiagnosticStreams diagnostics);
+
+// Streams the C++ (or C for --emit=c) for an analyzed program to 'emitter'
+void generate_code(const ProgramNode* program, const DriverOptions& options, Emitter& emitter);
+
+// --split-tu: the C++ for an analyzed program as a shared header and translation units
+SplitProgram generate_split_code(const ProgramNode* program, const DriverOptions& options);
+
+// The -run half of the pipeline: compiles generated code with the backend compiler and runs
+// the result. The toolchain is resolved once on construction (throws when none is found);
+// the precompiled header is prepared on first use. Only the toolchain-related options
+// (backend_key()) matter here, so one Backend serves every compilation that agrees on them.
+// Safe to share between threads.
+class Backend {
+public:
+    explicit Backend(const DriverOptions& options);
+
+    // Options that pick the toolchain, flags and precompiled header (which differs by runtime)
+    static std::string backend_key(const DriverOptions& options);
+
+    // Builds the precompiled header now rather than on the first compile; messages go to
+    // 'out'/'err'. Batches call this up front so the message does not land in a random file.
+    void prepare(std::ostream& out, std::ostream& err);
+
+    // cl cannot read source from stdin; the code must be written to a file first
+    bool needs_source_file() const { return toolchain.is_msvc; }
+
+    // Compiles the code of 'translation_units' (each is complete on its own; the matching
+    // 'source_filenames' hold copies when needs_source_file()), links them, runs the
+    // executable and reports all of it to 'out'/'err'. Several units are compiled in parallel.
+    // 'exe_filename' is where the executable goes when it can neither be cached nor kept in
+    // memory; 'job_limiter' (may be null) bounds how many compilers and programs run at once.
+    // Returns the driver's exit status.
+    int compile_and_run(const std::vector<std::string>& translation_units, const std::vector<std::string>& source_filenames, const std::string& exe_filename,
+                        const DriverOptions& options, JobLimiter* job_limiter, std::ostream& out, std::ostream& err);
+
+private:
+    bool emit_c;
+    bool link_runtime;
+    RuntimeKind runtime;
+    Toolchain toolchain;
+    // Flags that shape the binary; together with the code and the compiler they key the cache
+    std::vector<std::string> compile_flags;
+    ExecutableCache executable_cache;
+
+    std::once_flag precompiled_header_once;
+    std::string precompiled_header;
+
+    // Compiles (and without 'compile_only', links) code read from stdin, or the source files for cl
+    std::vector<std::string> compile_command(const std::vector<std::string>& source_filenames, const std::string& output_path, bool compile_only, std::ostream& out, std::ostream& err);
+    std::vector<std::string> link_command(const std::vector<std::string>& object_filenames, const std::string& output_path) const;
+    // Compiles every unit to an object file in parallel, then links them into 'output_path'
+    ProcessResult build_translation_units(const std::vector<std::string>& translation_units, const std::string& output_path, const std::vector<int>& inherited_fds,
+                                          JobLimiter* job_limiter, std::ostream& out, std::ostream& err);
+};
+
+// Analyzed programs keyed by a SHA-256 hash of their source (and -v), together with the messages
+// analysis printed, so that compiling an unchanged script again skips the front end and
+// replays its output. Keeps the most recently used 'capacity' programs; thread-safe.
+class AnalysisCache {
+public:
+    struct Entry {
+        std::shared_ptr<const ProgramNode> program;
+        std::string info;     // What analysis wrote to DiagnosticStreams::info
+        std::string warnings; // ... and to DiagnosticStreams::warnings
+    };
+
+    explicit AnalysisCache(size_t capacity = 256) : capacity(capacity) {}
+
+    static std::string key(const std::string& source_code, const DriverOptions& options);
+    std::shared_ptr<const Entry> find(const std::string& key);
+    void insert(const std::string& key, std::shared_ptr<const Entry> entry);
+
+private:
+    size_t capacity;
+    std::mutex mutex;
+    std::list<std::string> recency; // Most recently used first
+    std::unordered_map<std::string, std::pair<std::shared_ptr<const Entry>, std::list<std::string>::iterator>> entries;
+};
+
+// State that outlives a single compilation. A normal invocation uses one for its lifetime;
+// the compile server keeps one warm across requests.
+class CompilerSession {
+public:
+    explicit CompilerSession(bool cache_analyses = false);
+
+    // The Backend for 'options', created on first use (throws like Backend's constructor)
+    Backend& backend(const DriverOptions& options);
+    AnalysisCache* analysis_cache() { return analyses.get(); }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Backend>> backends;
+    std::unique_ptr<AnalysisCache> analyses;
+};
+
+// What compile_file needs besides the options; every member may be null
+struct CompileContext {
+    Backend* backend = nullptr;              // Required with -run
+    JobLimiter* job_limiter = nullptr;       // Bounds the backend processes of a batch
+    AnalysisCache* analysis_cache = nullptr; // Reuses analyses of unchanged sources
+    std::string* previous_code = nullptr;    // --watch: the last code generated; updated, and an
+                                             // identical result is not written again
+};
+
+// Compiles one script the way `humanscript_compiler <input> [options]` does, writing all
+// messages (and the program's output under -run) to 'out' and 'err'. Returns the process
+// exit status.
+int compile_file(const std::string& input_filename, const DriverOptions& options, const CompileContext& context, std::ostream& out, std::ostream& err);
@@ -0,0 +1,102 @@
+#include "emitter.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+    #define HS_WRITE _write
+    #define HS_CLOSE _close
+    #define HS_OPEN(path) _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644)
+#else
+    #include <unistd.h>
+    #define HS_WRITE ::write
+    #define HS_CLOSE ::close
+    #define HS_OPEN(path) ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+#endif
+
+FileDescriptorSink::FileDescriptorSink(int fd, bool owns_fd) : fd(fd), owns_fd(owns_fd) {}
+
+FileDescriptorSink::FileDescriptorSink(const std::string& path) : fd(HS_OPEN(path.c_str())), owns_fd(true) {
+    if (fd < 0) {
+        throw std::runtime_error("Could not open output file '" + path + "': " + std::strerror(errno));
+    }
+}
+
+FileDescriptorSink::~FileDescriptorSink() {
+    if (owns_fd && fd >= 0) {
+        HS_CLOSE(fd);
+    }
+}
+
+void FileDescriptorSink::write(const char* data, size_t size) {
+    while (size > 0) {
+        auto written = HS_WRITE(fd, data, static_cast<unsigned>(size));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Write to output failed: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void FileDescriptorSink::close() {
+    if (owns_fd && fd >= 0) {
+        int result = HS_CLOSE(fd);
+        fd = -1;
+        if (result != 0) {
+            throw std::runtime_error(std::string("Closing output failed: ") + std::strerror(errno));
+        }
+    }
+}
+
+Emitter::Emitter(OutputSink& sink, size_t chunk_size)
+    : sink(sink), buffer(new char[chunk_size]), capacity(chunk_size) {}
+
+Emitter::~Emitter() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; callers that care call flush() themselves
+    }
+}
+
+void Emitter::write(const char* data, size_t size) {
+    total_bytes += size;
+    if (used + size <= capacity) {
+        std::memcpy(buffer.get() + used, data, size);
+        used += size;
+        return;
+    }
+    // Top up the current chunk, hand it over, and pass very large writes straight through
+    size_t room = capacity - used;
+    std::memcpy(buffer.get() + used, data, room);
+    sink.write(buffer.get(), capacity);
+    used = 0;
+    data += room;
+    size -= room;
+    if (size >= capacity) {
+        sink.write(data, size);
+        return;
+    }
+    std::memcpy(buffer.get(), data, size);
+    used = size;
+}
+
+Emitter& Emitter::operator<<(char c) {
+    if (used == capacity) {
+        sink.write(buffer.get(), capacity);
+        used = 0;
+    }
+    buffer[used++] = c;
+    total_bytes++;
+    return *this;
+}
+
+void Emitter::flush() {
+    if (used > 0) {
+        sink.write(buffer.get(), used);
+        used = 0;
+    }
+    sink.flush();
+}
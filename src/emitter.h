@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+#include <stdexcept>
+
+// Destination for generated code. Sinks receive data in chunks from an Emitter.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+    virtual void flush() {}
+};
+
+// Writes to a file descriptor with write(2), retrying short writes.
+class FileDescriptorSink : public OutputSink {
+public:
+    explicit FileDescriptorSink(int fd, bool owns_fd = false);
+    explicit FileDescriptorSink(const std::string& path); // Creates/truncates 'path'; throws on failure
+    ~FileDescriptorSink() override;
+
+    FileDescriptorSink(const FileDescriptorSink&) = delete;
+    FileDescriptorSink& operator=(const FileDescriptorSink&) = delete;
+
+    void write(const char* data, size_t size) override;
+    void close(); // Throws if closing reports a write error
+
+private:
+    int fd;
+    bool owns_fd;
+};
+
+// Collects everything in memory (used when the caller wants the code as a string).
+class MemorySink : public OutputSink {
+public:
+    void write(const char* data, size_t size) override { data_.append(data, size); }
+    const std::string& str() const { return data_; }
+    std::string take() { return std::move(data_); }
+
+private:
+    std::string data_;
+};
+
+// Fixed-size buffer in front of an OutputSink. The buffer is handed to the sink each
+// time it fills up, so memory use stays at one chunk regardless of the output size.
+class Emitter {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    explicit Emitter(OutputSink& sink, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+    ~Emitter(); // Flushes what is left; call flush() explicitly to see errors
+
+    Emitter(const Emitter&) = delete;
+    Emitter& operator=(const Emitter&) = delete;
+
+    void write(const char* data, size_t size);
+    void flush();
+    size_t bytes_written() const { return total_bytes; }
+
+    Emitter& operator<<(std::string_view text) { write(text.data(), text.size()); return *this; }
+    Emitter& operator<<(const std::string& text) { write(text.data(), text.size()); return *this; }
+    Emitter& operator<<(const char* text) { return *this << std::string_view(text); }
+    Emitter& operator<<(char c);
+
+private:
+    OutputSink& sink;
+    std::unique_ptr<char[]> buffer;
+    size_t capacity;
+    size_t used = 0;
+    size_t total_bytes = 0;
+};
@@ -0,0 +1,114 @@
+#include "executable_cache.h"
+#include "cache_directory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* TEMPORARY_MARKER = ".tmp";
+// A temporary file this old belongs to a run that died before publishing it
+constexpr auto STALE_TEMPORARY_AGE = std::chrono::hours(1);
+
+#if defined(_WIN32) || defined(_WIN64)
+constexpr const char* EXECUTABLE_SUFFIX = ".exe";
+#else
+constexpr const char* EXECUTABLE_SUFFIX = "";
+#endif
+
+} // namespace
+
+ExecutableCache::ExecutableCache() {
+    if (const char* limit = std::getenv("HUMANSCRIPT_CACHE_LIMIT_MB"); limit && *limit) {
+        char* end = nullptr;
+        unsigned long long megabytes = std::strtoull(limit, &end, 10);
+        if (end && *end == '\0') {
+            size_limit = static_cast<uintmax_t>(megabytes) * 1024 * 1024;
+        }
+    }
+    std::string cache_directory = humanscript_cache_directory();
+    if (cache_directory.empty()) return;
+    fs::path exe_directory = fs::path(cache_directory) / "exe";
+    std::error_code error;
+    fs::create_directories(exe_directory, error);
+    if (!error) {
+        directory = exe_directory.string();
+    }
+}
+
+std::string ExecutableCache::lookup(const std::string& key) const {
+    if (!enabled()) return "";
+    fs::path entry = fs::path(directory) / (key + EXECUTABLE_SUFFIX);
+    std::error_code error;
+    if (!fs::is_regular_file(entry, error)) return "";
+    // Reading a file does not reliably update its atime (noatime, relatime), so recency
+    // is tracked with the modification time
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+    return entry.string();
+}
+
+std::string ExecutableCache::temporary_path(const std::string& key) const {
+    // Unique per process and per call: a batch may build the same script on two threads
+    static std::atomic<unsigned> counter{0};
+    std::string name = key + TEMPORARY_MARKER;
+    #ifndef _WIN32
+    name += std::to_string(static_cast<long long>(getpid())) + "-";
+    #endif
+    name += std::to_string(counter++);
+    return (fs::path(directory) / (name + EXECUTABLE_SUFFIX)).string();
+}
+
+std::string ExecutableCache::insert(const std::string& key, const std::string& built_path) const {
+    fs::path entry = fs::path(directory) / (key + EXECUTABLE_SUFFIX);
+    std::error_code error;
+    // rename() replaces an entry a concurrent run published first; both hold the same binary
+    fs::rename(built_path, entry, error);
+    if (error) return built_path;
+    evict(entry.string());
+    return entry.string();
+}
+
+void ExecutableCache::evict(const std::string& keep) const {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type last_used;
+        uintmax_t size;
+    };
+    std::vector<Entry> entries;
+    uintmax_t total_size = 0;
+    auto now = fs::file_time_type::clock::now();
+
+    std::error_code error;
+    for (const auto& item : fs::directory_iterator(directory, error)) {
+        std::error_code item_error;
+        if (!item.is_regular_file(item_error)) continue;
+        auto last_used = item.last_write_time(item_error);
+        uintmax_t size = item.file_size(item_error);
+        if (item_error) continue;
+        if (item.path().filename().string().find(TEMPORARY_MARKER) != std::string::npos) {
+            if (now - last_used > STALE_TEMPORARY_AGE) fs::remove(item.path(), item_error);
+            continue; // Possibly a build in progress
+        }
+        entries.push_back({item.path(), last_used, size});
+        total_size += size;
+    }
+    if (total_size <= size_limit) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.last_used < b.last_used; });
+    for (const auto& entry : entries) {
+        if (total_size <= size_limit) break;
+        if (entry.path.string() == keep) continue;
+        if (fs::remove(entry.path, error)) {
+            total_size -= entry.size;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Content-addressed store of -run executables under <humanscript_cache_directory()>/exe.
+// Entries are named by a caller-computed key (a SHA-256 of the generated code, the compiler
+// identity and the flags; a weaker hash could silently run another program's binary), so a
+// hit can be run without compiling. Entries are published
+// with an atomic rename, so concurrent runs never see a partial binary, and the least
+// recently used ones are evicted once the directory grows past the size limit.
+class ExecutableCache {
+public:
+    static constexpr uintmax_t DEFAULT_SIZE_LIMIT = 256ull * 1024 * 1024;
+
+    // Uses $HUMANSCRIPT_CACHE_LIMIT_MB as the size limit when set; disabled (enabled()
+    // is false) when no cache directory is available
+    ExecutableCache();
+
+    bool enabled() const { return !directory.empty(); }
+
+    // Path of the cached executable for 'key', marked as recently used; empty on a miss
+    std::string lookup(const std::string& key) const;
+    // Where to build the executable for 'key' before insert(); unique to this process
+    std::string temporary_path(const std::string& key) const;
+    // Moves a finished build from temporary_path() into place and evicts old entries.
+    // Returns the cached path, or 'built_path' itself if it could not be moved.
+    std::string insert(const std::string& key, const std::string& built_path) const;
+
+private:
+    std::string directory;
+    uintmax_t size_limit = DEFAULT_SIZE_LIMIT;
+
+    void evict(const std::string& keep) const;
+};
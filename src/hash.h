@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 64-bit FNV-1a; used to key on-disk caches, not for security
+class Fnv1aHash {
+public:
+    Fnv1aHash& add(std::string_view data) {
+        for (unsigned char c : data) {
+            state = (state ^ c) * 0x100000001b3ULL;
+        }
+        return add_separator();
+    }
+    uint64_t value() const { return state; }
+    std::string hex() const {
+        static const char digits[] = "0123456789abcdef";
+        std::string text(16, '0');
+        for (int i = 15, shift = 0; i >= 0; --i, shift += 4) {
+            text[i] = digits[(state >> shift) & 0xf];
+        }
+        return text;
+    }
+
+private:
+    uint64_t state = 0xcbf29ce484222325ULL;
+
+    // Keeps ("ab", "c") and ("a", "bc") apart
+    Fnv1aHash& add_separator() {
+        state = (state ^ 0xff) * 0x100000001b3ULL;
+        return *this;
+    }
+};
+
+// SHA-256, for keys where a collision would silently do the wrong thing (the executable
+// cache runs whatever binary sits under a key, the analysis cache whatever program, and
+// --watch skips a save that hashes like the last one). Same add() interface as Fnv1aHash.
+class Sha256Hash {
+public:
+    Sha256Hash();
+    // Length-prefixed, which keeps ("ab", "c") and ("a", "bc") apart
+    Sha256Hash& add(std::string_view data);
+    // Hex digest of everything added; the hash cannot be added to afterwards
+    std::string hex();
+
+private:
+    std::array<uint32_t, 8> state;
+    std::array<unsigned char, 64> block;
+    size_t block_size = 0;
+    uint64_t total_size = 0;
+
+    void append(const unsigned char* data, size_t size);
+    void compress();
+};
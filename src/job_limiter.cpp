@@ -0,0 +1,104 @@
+#include "job_limiter.h"
+#include <cerrno>
+#include <cstdlib>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+JobLimiter::JobLimiter(size_t jobs) : jobs(jobs == 0 ? 1 : jobs) {
+    if (const char* makeflags = std::getenv("MAKEFLAGS"); makeflags && *makeflags) {
+        connect_to_jobserver(makeflags);
+    }
+}
+
+JobLimiter::~JobLimiter() {
+    #ifndef _WIN32
+    if (owns_jobserver_fds) {
+        close(jobserver_read);
+        if (jobserver_write != jobserver_read) close(jobserver_write);
+    }
+    #endif
+}
+
+// MAKEFLAGS carries "--jobserver-auth=R,W" (inherited pipe descriptors), "--jobserver-auth=
+// fifo:PATH" (make 4.4) or, before make 4.2, "--jobserver-fds=R,W". The last one wins, as in
+// make. Descriptors that are not open mean make did not pass them to us (a recipe without
+// '+'); the jobserver is then ignored and only -j applies.
+void JobLimiter::connect_to_jobserver(const std::string& makeflags) {
+    #ifndef _WIN32
+    std::string auth;
+    for (const char* option : {"--jobserver-auth=", "--jobserver-fds="}) {
+        size_t pos = makeflags.rfind(option);
+        if (pos == std::string::npos) continue;
+        size_t start = pos + std::string(option).size();
+        auth = makeflags.substr(start, makeflags.find(' ', start) - start);
+        break;
+    }
+    if (auth.empty()) return;
+
+    if (auth.rfind("fifo:", 0) == 0) {
+        int fd = open(auth.c_str() + 5, O_RDWR | O_CLOEXEC);
+        if (fd < 0) return;
+        jobserver_read = jobserver_write = fd;
+        owns_jobserver_fds = true;
+        return;
+    }
+    size_t comma = auth.find(',');
+    if (comma == std::string::npos) return;
+    int read_fd = std::atoi(auth.substr(0, comma).c_str());
+    int write_fd = std::atoi(auth.substr(comma + 1).c_str());
+    if (read_fd < 0 || write_fd < 0 || fcntl(read_fd, F_GETFD) < 0 || fcntl(write_fd, F_GETFD) < 0) return;
+    jobserver_read = read_fd;
+    jobserver_write = write_fd;
+    #else
+    (void)makeflags;
+    #endif
+}
+
+// One byte from the jobserver; make may have left the pipe non-blocking, so wait with poll
+int JobLimiter::read_token() {
+    #ifndef _WIN32
+    while (true) {
+        unsigned char token;
+        ssize_t n = read(jobserver_read, &token, 1);
+        if (n == 1) return token;
+        if (n == 0) return NO_TOKEN; // make went away: run without a token rather than hang
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            pollfd fd = {jobserver_read, POLLIN, 0};
+            poll(&fd, 1, -1);
+        } else if (errno != EINTR) {
+            return NO_TOKEN;
+        }
+    }
+    #else
+    return NO_TOKEN;
+    #endif
+}
+
+int JobLimiter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    slot_freed.wait(lock, [this] { return running < jobs; });
+    ++running;
+    if (!uses_jobserver() || !implicit_token_in_use) {
+        implicit_token_in_use = uses_jobserver();
+        return IMPLICIT_TOKEN;
+    }
+    lock.unlock(); // Other jobs may finish (and hand tokens back) while we wait on make
+    return read_token();
+}
+
+void JobLimiter::release(int token) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (token >= 0) {
+        #ifndef _WIN32
+        unsigned char byte = static_cast<unsigned char>(token);
+        while (write(jobserver_write, &byte, 1) < 0 && errno == EINTR) {}
+        #endif
+    } else if (token == IMPLICIT_TOKEN) {
+        implicit_token_in_use = false;
+    }
+    --running;
+    slot_freed.notify_one();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+// Bounds how many backend processes (compilers and compiled programs) a batch runs at once.
+// The local limit comes from -j. When MAKEFLAGS names a GNU make jobserver, every job beyond
+// the first also takes a token from it, so a `make -jN` that runs humanscript_compiler
+// keeps its global limit; the first job runs on the token make granted this process.
+class JobLimiter {
+public:
+    explicit JobLimiter(size_t jobs);
+    ~JobLimiter();
+
+    JobLimiter(const JobLimiter&) = delete;
+    JobLimiter& operator=(const JobLimiter&) = delete;
+
+    static constexpr int IMPLICIT_TOKEN = -1; // The first job, or no jobserver at all
+    static constexpr int NO_TOKEN = -2;       // The jobserver failed; ran on the local limit only
+
+    // Blocks until a job may start; returns the jobserver token taken, which must be passed
+    // back to release()
+    int acquire();
+    void release(int token);
+
+    size_t limit() const { return jobs; }
+    bool uses_jobserver() const { return jobserver_read >= 0; }
+
+private:
+    size_t jobs;
+    size_t running = 0;
+    bool implicit_token_in_use = false;
+    std::mutex mutex;
+    std::condition_variable slot_freed;
+
+    int jobserver_read = -1;
+    int jobserver_write = -1;
+    bool owns_jobserver_fds = false; // Opened from a fifo: path rather than inherited
+
+    void connect_to_jobserver(const std::string& makeflags);
+    int read_token();
+};
@@ -9,7 +9,7 @@ Token::Token(TokenType t, std::string txt, std::variant<std::monostate, int, lon
     : type(t), text(std::move(txt)), value(std::move(val)) {}
 
 
-Lexer::Lexer(std::string source) : source_code(std::move(source)) {}
+Lexer::Lexer(std::string source, DiagnosticStreams diagnostics) : source_code(std::move(source)), diagnostics(diagnostics) {}
 
 char Lexer::peek() {
     if (current_pos >= source_code.length()) return '\0';
@@ -79,7 +79,7 @@ Token Lexer::make_number() {
         try {
             return Token(TokenType::DOUBLE_LITERAL, num_str, std::stod(num_str));
         } catch (const std::out_of_range&) {
-            std::cerr << "Lexer Warning: Double literal '" << num_str << "' out of range." << std::endl;
+            *diagnostics.warnings << "Lexer Warning: Double literal '" << num_str << "' out of range." << std::endl;
             return Token(TokenType::DOUBLE_LITERAL, num_str, 0.0); // Default or error
         }
     } else {
@@ -92,7 +92,7 @@ Token Lexer::make_number() {
              try {
                 return Token(TokenType::INTEGER_LITERAL, num_str, std::stoll(num_str)); // Try as long long
             } catch (const std::out_of_range&) {
-                std::cerr << "Lexer Warning: Integer literal '" << num_str << "' out of range for long long." << std::endl;
+                *diagnostics.warnings << "Lexer Warning: Integer literal '" << num_str << "' out of range for long long." << std::endl;
                 return Token(TokenType::INTEGER_LITERAL, num_str, 0LL); // Default or error
             }
         }
@@ -121,7 +121,7 @@ Token Lexer::make_string_literal() {
     if (peek() == '"') {
         advance(); // Consume the closing quote
     } else {
-        std::cerr << "Lexer Error: Unterminated string literal." << std::endl;
+        *diagnostics.warnings << "Lexer Error: Unterminated string literal." << std::endl;
         // Return an error token or handle differently
     }
     return Token(TokenType::STRING_LITERAL, "\"" + str_val + "\"", str_val);
@@ -173,7 +173,7 @@ Token Lexer::get_next_token() {
     }
 
     // If no match
-    std::cerr << "Lexer Error: Unknown character '" << current_char << "' on line " << line_number << std::endl;
+    *diagnostics.warnings << "Lexer Error: Unknown character '" << current_char << "' on line " << line_number << std::endl;
     advance();
     return Token(TokenType::UNKNOWN, std::string(1, current_char));
 }
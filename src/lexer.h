@@ -1,4 +1,5 @@
 #pragma once
+#include "diagnostics.h"
 #include <string>
 #include <vector>
 #include <variant>
@@ -66,11 +67,12 @@ struct Token {
 
 class Lexer {
 public:
-    Lexer(std::string source);
+    Lexer(std::string source, DiagnosticStreams diagnostics = {});
     std::vector<Token> tokenize();
 
 private:
     std::string source_code;
+    DiagnosticStreams diagnostics;
     size_t current_pos = 0;
     size_t line_number = 1; // For error reporting (optional for now)
 
@@ -0,0 +1,44 @@
+#include "memory_file.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MemoryFile::MemoryFile(const char* name) {
+    #ifdef __linux__
+    fd = memfd_create(name, MFD_CLOEXEC); // Handed to a child explicitly; see path()
+    #else
+    (void)name;
+    #endif
+}
+
+MemoryFile::~MemoryFile() {
+    #ifdef __linux__
+    if (fd >= 0) close(fd);
+    #endif
+}
+
+std::string MemoryFile::path() const {
+    return "/proc/self/fd/" + std::to_string(fd);
+}
+
+bool MemoryFile::make_executable() {
+    #ifdef __linux__
+    int read_only = open(path().c_str(), O_RDONLY | O_CLOEXEC);
+    if (read_only < 0) return false;
+    close(fd);
+    fd = read_only;
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+bool MemoryFile::empty() const {
+    #ifdef __linux__
+    return lseek(fd, 0, SEEK_END) <= 0;
+    #else
+    return true;
+    #endif
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+
+// Anonymous in-memory file (Linux memfd_create) for -run artifacts that should never reach
+// the filesystem. A compiler given descriptor() in run_process's 'inherited_fds' can be told
+// to write it through inherited_fd_path(); the result is then started with run_process_from_fd().
+class MemoryFile {
+public:
+    explicit MemoryFile(const char* name); // valid() is false where memfd is unavailable
+    ~MemoryFile();
+
+    MemoryFile(const MemoryFile&) = delete;
+    MemoryFile& operator=(const MemoryFile&) = delete;
+
+    bool valid() const { return fd >= 0; }
+    int descriptor() const { return fd; }
+    // "/proc/self/fd/N": names the file in this process
+    std::string path() const;
+    // Swaps the writable descriptor for a read-only, close-on-exec one. Required before
+    // executing the file: the kernel refuses to exec a file open for writing (ETXTBSY).
+    bool make_executable();
+    bool empty() const;
+
+private:
+    int fd = -1;
+};
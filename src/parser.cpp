@@ -1,7 +1,7 @@
 #include "parser.h"
 #include <iostream>
 
-Parser::Parser(std::vector<Token> tokens) : tokens_list(std::move(tokens)) {}
+Parser::Parser(std::vector<Token> tokens, DiagnosticStreams diagnostics) : tokens_list(std::move(tokens)), diagnostics(diagnostics) {}
 
 Token Parser::peek() {
     if (current_token_idx >= tokens_list.size()) {
@@ -60,7 +60,7 @@ std::unique_ptr<ProgramNode> Parser::parse_program() {
                 break;
             }
         } catch (const std::runtime_error& e) {
-            std::cerr << e.what() << std::endl;
+            *diagnostics.warnings << e.what() << std::endl;
             throw; 
         }
     }
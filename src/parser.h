@@ -1,17 +1,19 @@
 #pragma once
 #include "lexer.h"
 #include "ast.h"
+#include "diagnostics.h"
 #include <vector>
 #include <memory>
 #include <stdexcept> 
 
 class Parser {
 public:
-    Parser(std::vector<Token> tokens);
+    Parser(std::vector<Token> tokens, DiagnosticStreams diagnostics = {});
     std::unique_ptr<ProgramNode> parse_program();
 
 private:
     std::vector<Token> tokens_list; 
+    DiagnosticStreams diagnostics;
     size_t current_token_idx = 0;
     
     Token peek();
@@ -0,0 +1,94 @@
+#include "precompiled_header.h"
+#include "cache_directory.h"
+#include "hash.h"
+#include "process.h"
+#include "toolchain.h"
+#include "runtime_source.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string precompiled_header_source(bool link_runtime, RuntimeKind runtime) {
+    std::string source = "// Precompiled by humanscript_compiler for -run; do not edit.\n";
+    for (const char* header : {"cerrno", "charconv", "csignal", "cstddef", "cstdlib", "cstring",
+                               "exception", "string", "string_view"}) {
+        source += "#include <" + std::string(header) + ">\n";
+    }
+    if (runtime == RuntimeKind::IOSTREAM) {
+        source += "#include <iostream>\n";
+    }
+    source += "#ifdef _WIN32\n#include <io.h>\n#else\n#include <unistd.h>\n#endif\n";
+    if (link_runtime) {
+        source += "#include \"humanscript_runtime.h\"\n";
+    }
+    return source;
+}
+
+bool write_file(const fs::path& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+std::string prepare_precompiled_header(const Toolchain& toolchain, const std::vector<std::string>& flags, bool link_runtime, RuntimeKind runtime,
+                                       DiagnosticStreams diagnostics) {
+    #ifdef _WIN32
+    return ""; // cl uses /Yc and /Yu, which this pipeline does not drive
+    #else
+    std::string cache_directory = humanscript_cache_directory();
+    if (toolchain.version.empty() || toolchain.is_msvc || cache_directory.empty()) return "";
+
+    std::string source = precompiled_header_source(link_runtime, runtime); // Hashed below, so each runtime gets its own
+    Fnv1aHash key;
+    key.add(toolchain.path).add(toolchain.version);
+    for (const auto& flag : flags) key.add(flag);
+    key.add(source);
+    if (link_runtime) {
+        key.add(HUMANSCRIPT_RUNTIME_SOURCE); // Rebuild when the runtime header changes
+    }
+
+    fs::path directory = fs::path(cache_directory) / ("pch-" + key.hex());
+    fs::path header = directory / "humanscript_pch.h";
+    fs::path precompiled = header;
+    precompiled += toolchain.is_clang ? ".pch" : ".gch";
+
+    std::error_code error;
+    if (fs::exists(precompiled, error)) {
+        return header.string();
+    }
+
+    // Build under temporary names and rename into place, so concurrent runs never see a
+    // partial file; whichever rename lands last wins with identical contents
+    fs::create_directories(directory, error);
+    std::string suffix = ".tmp" + std::to_string(static_cast<long long>(getpid()));
+    fs::path temp_header = header;
+    temp_header += suffix;
+    if (error || !write_file(temp_header, source)) return "";
+    fs::rename(temp_header, header, error);
+    if (error) return "";
+
+    fs::path temp_precompiled = precompiled;
+    temp_precompiled += suffix;
+    std::vector<std::string> command = {toolchain.path};
+    command.insert(command.end(), flags.begin(), flags.end());
+    command.insert(command.end(), {"-x", "c++-header", header.string(), "-o", temp_precompiled.string()});
+    *diagnostics.info << "Building precompiled header: " << precompiled.string() << std::endl;
+    if (!run_process(command, "", *diagnostics.info, *diagnostics.warnings).succeeded()) {
+        *diagnostics.warnings << "Warning: Could not build precompiled header; compiling without it." << std::endl;
+        fs::remove(temp_precompiled, error);
+        return "";
+    }
+    fs::rename(temp_precompiled, precompiled, error);
+    return error ? "" : header.string();
+    #endif
+}
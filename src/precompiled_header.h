@@ -0,0 +1,17 @@
+#pragma once
+#include "code_generator.h" // RuntimeKind
+#include "diagnostics.h"
+#include <string>
+#include <vector>
+
+struct Toolchain;
+
+// Precompiled header for the -run pipeline, covering everything CodeGenerator can
+// auto-include for 'runtime' (and the runtime header when the runtime library is linked);
+// <iostream> is left out for the minimal runtime, whose programs must not pay for its static
+// initializer. It is built once per compiler binary, version, flag set and header list and
+// cached under humanscript_cache_directory().
+// Returns the header to pass with -include (the compiler picks up the .gch/.pch next to
+// it), or an empty string when no precompiled header is available.
+std::string prepare_precompiled_header(const Toolchain& toolchain, const std::vector<std::string>& flags, bool link_runtime, RuntimeKind runtime,
+                                       DiagnosticStreams diagnostics = {});
@@ -0,0 +1,242 @@
+#include "process.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#if defined(_WIN32) || defined(_WIN64)
+    #include <cstdlib>
+#else
+    #include <csignal>
+    #include <mutex>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <spawn.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    extern char** environ;
+#endif
+
+namespace {
+constexpr int FIRST_INHERITED_FD = 3; // Right after stdin, stdout and stderr
+}
+
+std::string ProcessResult::describe() const {
+    if (!started) return "could not be started";
+    if (signal != 0) return "signal " + std::to_string(signal);
+    return "exit code " + std::to_string(exit_code);
+}
+
+std::string inherited_fd_path(size_t index) {
+    return "/proc/self/fd/" + std::to_string(FIRST_INHERITED_FD + static_cast<int>(index));
+}
+
+std::string command_line_for_display(const std::vector<std::string>& argv) {
+    std::string line;
+    for (const auto& arg : argv) {
+        if (!line.empty()) line += ' ';
+        line += arg.find_first_of(" \t\"") == std::string::npos ? arg : "\"" + arg + "\"";
+    }
+    return line;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+// No posix_spawn: go through the shell, feeding stdin with _popen; output is not captured
+ProcessResult run_process(const std::vector<std::string>& argv, std::string_view input, std::ostream&, std::ostream&, const std::vector<int>&) {
+    ProcessResult result;
+    FILE* pipe = _popen(command_line_for_display(argv).c_str(), "wb");
+    if (!pipe) return result;
+    result.started = true;
+    std::fwrite(input.data(), 1, input.size(), pipe);
+    result.exit_code = _pclose(pipe);
+    return result;
+}
+
+ProcessResult run_process_from_fd(int, const std::vector<std::string>&, std::string_view, std::ostream&, std::ostream&) {
+    return {};
+}
+
+#else
+
+namespace {
+
+struct Pipe {
+    int read_end = -1;
+    int write_end = -1;
+    bool open() {
+        int fds[2];
+        // Only the dup2'd copies in the child survive exec. pipe2 sets close-on-exec
+        // atomically, so a process spawned by another thread cannot inherit these ends.
+        #ifdef __linux__
+        if (pipe2(fds, O_CLOEXEC) != 0) return false;
+        #else
+        if (pipe(fds) != 0) return false;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        #endif
+        read_end = fds[0];
+        write_end = fds[1];
+        return true;
+    }
+    void close_read() { if (read_end >= 0) { ::close(read_end); read_end = -1; } }
+    void close_write() { if (write_end >= 0) { ::close(write_end); write_end = -1; } }
+    ~Pipe() { close_read(); close_write(); }
+};
+
+// A child that exits without reading all of its input must not kill us with SIGPIPE.
+// Ignored once for the whole process, as a per-call sigaction would race between threads;
+// children get the default action back before exec.
+void ignore_sigpipe() {
+    static std::once_flag once;
+    std::call_once(once, [] { std::signal(SIGPIPE, SIG_IGN); });
+}
+
+// Starts argv (or the program open as 'executable_fd', when >= 0) with stdin, stdout and
+// stderr on the given pipes and 'inherited_fds' kept open; returns 0 or the errno that
+// prevented the start
+int start_child(const std::vector<std::string>& argv, int executable_fd, const std::vector<int>& inherited_fds,
+                Pipe& stdin_pipe, Pipe& stdout_pipe, Pipe& stderr_pipe, pid_t& pid) {
+    std::vector<char*> args;
+    for (const auto& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+    args.push_back(nullptr);
+
+    if (executable_fd < 0) {
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, stdin_pipe.read_end, 0);
+        posix_spawn_file_actions_adddup2(&actions, stdout_pipe.write_end, 1);
+        posix_spawn_file_actions_adddup2(&actions, stderr_pipe.write_end, 2);
+        for (size_t i = 0; i < inherited_fds.size(); ++i) {
+            // dup2 onto the same number still clears close-on-exec in the child
+            posix_spawn_file_actions_adddup2(&actions, inherited_fds[i], FIRST_INHERITED_FD + static_cast<int>(i));
+        }
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        sigset_t default_signals;
+        sigemptyset(&default_signals);
+        sigaddset(&default_signals, SIGPIPE);
+        posix_spawnattr_setsigdefault(&attributes, &default_signals);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+        int spawn_error = argv[0].find('/') == std::string::npos
+            ? posix_spawnp(&pid, args[0], &actions, &attributes, args.data(), environ)
+            : posix_spawn(&pid, args[0], &actions, &attributes, args.data(), environ);
+        posix_spawnattr_destroy(&attributes);
+        posix_spawn_file_actions_destroy(&actions);
+        return spawn_error;
+    }
+
+    #ifdef __linux__
+    // posix_spawn cannot start a program from a descriptor: fork and fexecve. A close-on-exec
+    // pipe carries the errno back if fexecve fails, and closes silently once it succeeds.
+    Pipe status_pipe;
+    if (!status_pipe.open()) return errno;
+    pid = fork();
+    if (pid < 0) return errno;
+    if (pid == 0) {
+        dup2(stdin_pipe.read_end, 0);
+        dup2(stdout_pipe.write_end, 1);
+        dup2(stderr_pipe.write_end, 2);
+        for (size_t i = 0; i < inherited_fds.size(); ++i) {
+            int target = FIRST_INHERITED_FD + static_cast<int>(i);
+            if (inherited_fds[i] == target) fcntl(target, F_SETFD, 0); else dup2(inherited_fds[i], target);
+        }
+        signal(SIGPIPE, SIG_DFL);
+        fexecve(executable_fd, args.data(), environ);
+        int error = errno;
+        ssize_t ignored = ::write(status_pipe.write_end, &error, sizeof error);
+        (void)ignored;
+        _exit(127);
+    }
+    status_pipe.close_write();
+    int child_error = 0;
+    ssize_t n;
+    while ((n = ::read(status_pipe.read_end, &child_error, sizeof child_error)) < 0 && errno == EINTR) {}
+    if (n == static_cast<ssize_t>(sizeof child_error)) {
+        waitpid(pid, nullptr, 0);
+        return child_error;
+    }
+    return 0;
+    #else
+    return ENOSYS;
+    #endif
+}
+
+ProcessResult run(const std::vector<std::string>& argv, int executable_fd, const std::vector<int>& inherited_fds,
+                  std::string_view input, std::ostream& out, std::ostream& err) {
+    ProcessResult result;
+    if (argv.empty()) return result;
+
+    Pipe stdin_pipe, stdout_pipe, stderr_pipe;
+    if (!stdin_pipe.open() || !stdout_pipe.open() || !stderr_pipe.open()) return result;
+
+    pid_t pid;
+    ignore_sigpipe();
+    int spawn_error = start_child(argv, executable_fd, inherited_fds, stdin_pipe, stdout_pipe, stderr_pipe, pid);
+    stdin_pipe.close_read();
+    stdout_pipe.close_write();
+    stderr_pipe.close_write();
+    if (spawn_error != 0) {
+        err << "Error: Could not start '" << argv[0] << "': " << std::strerror(spawn_error) << std::endl;
+        return result;
+    }
+    result.started = true;
+
+    // Feed stdin and drain both outputs in one poll loop, so no pipe can fill up and stall
+    fcntl(stdin_pipe.write_end, F_SETFL, fcntl(stdin_pipe.write_end, F_GETFL) | O_NONBLOCK);
+    if (input.empty()) stdin_pipe.close_write();
+    char buffer[1 << 16];
+    while (stdin_pipe.write_end >= 0 || stdout_pipe.read_end >= 0 || stderr_pipe.read_end >= 0) {
+        pollfd fds[3];
+        nfds_t count = 0;
+        if (stdin_pipe.write_end >= 0) fds[count++] = {stdin_pipe.write_end, POLLOUT, 0};
+        if (stdout_pipe.read_end >= 0) fds[count++] = {stdout_pipe.read_end, POLLIN, 0};
+        if (stderr_pipe.read_end >= 0) fds[count++] = {stderr_pipe.read_end, POLLIN, 0};
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (nfds_t i = 0; i < count; ++i) {
+            if (fds[i].revents == 0) continue;
+            if (fds[i].fd == stdin_pipe.write_end) {
+                ssize_t written = ::write(stdin_pipe.write_end, input.data(), input.size());
+                if (written > 0) input.remove_prefix(static_cast<size_t>(written));
+                if ((written < 0 && errno != EAGAIN && errno != EINTR) || input.empty()) {
+                    stdin_pipe.close_write(); // Done, or the child stopped reading
+                }
+                continue;
+            }
+            bool is_stdout = fds[i].fd == stdout_pipe.read_end;
+            ssize_t n = ::read(fds[i].fd, buffer, sizeof buffer);
+            if (n > 0) {
+                (is_stdout ? out : err).write(buffer, n);
+            } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                is_stdout ? stdout_pipe.close_read() : stderr_pipe.close_read();
+            }
+        }
+    }
+    out.flush();
+    err.flush();
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return result;
+    }
+    if (WIFSIGNALED(status)) {
+        result.signal = WTERMSIG(status);
+    } else {
+        result.exit_code = WEXITSTATUS(status);
+    }
+    return result;
+}
+
+} // namespace
+
+ProcessResult run_process(const std::vector<std::string>& argv, std::string_view input, std::ostream& out, std::ostream& err,
+                          const std::vector<int>& inherited_fds) {
+    return run(argv, -1, inherited_fds, input, out, err);
+}
+
+ProcessResult run_process_from_fd(int executable_fd, const std::vector<std::string>& argv, std::string_view input, std::ostream& out, std::ostream& err) {
+    return run(argv, executable_fd, {}, input, out, err);
+}
+
+#endif
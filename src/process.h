@@ -0,0 +1,32 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ProcessResult {
+    bool started = false; // False when the program could not be spawned at all
+    int exit_code = -1;   // Exit status; -1 when not started or killed by a signal
+    int signal = 0;       // Terminating signal, 0 when the process exited normally
+
+    bool succeeded() const { return started && signal == 0 && exit_code == 0; }
+    std::string describe() const; // "exit code N", "signal N" or "could not be started"
+};
+
+// Runs argv[0] (looked up in PATH unless it contains a '/') directly, without a shell.
+// 'input' is written to its stdin, which is then closed; its stdout and stderr are read
+// through pipes and forwarded to 'out' and 'err' as they arrive. Descriptors the child should
+// keep (all others are close-on-exec) go in 'inherited_fds'; the child sees them as 3, 4, ...
+// so the command line can name them with inherited_fd_path(). Safe to call from several threads.
+ProcessResult run_process(const std::vector<std::string>& argv, std::string_view input, std::ostream& out, std::ostream& err,
+                          const std::vector<int>& inherited_fds = {});
+
+// Like run_process, but starts the program open as 'executable_fd' with fexecve (Linux only;
+// elsewhere the result is not started). argv[0] is only the name the program sees.
+ProcessResult run_process_from_fd(int executable_fd, const std::vector<std::string>& argv, std::string_view input, std::ostream& out, std::ostream& err);
+
+// "/proc/self/fd/N" for inherited_fds[index] as seen by the child (Linux)
+std::string inherited_fd_path(size_t index);
+
+// argv joined for display, quoting arguments that contain spaces
+std::string command_line_for_display(const std::vector<std::string>& argv);
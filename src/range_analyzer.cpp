@@ -0,0 +1,162 @@
+#include "range_analyzer.h"
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr ValueRange INT_RANGE = {std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+constexpr ValueRange LONG_LONG_RANGE = {std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()};
+
+bool is_integer_type(HScriptType type) {
+    return type == HScriptType::NUMBER || type == HScriptType::LNUMBER;
+}
+
+std::string range_to_string(const ValueRange& range) {
+    if (range.min == range.max) return std::to_string(range.min);
+    return "[" + std::to_string(range.min) + ", " + std::to_string(range.max) + "]";
+}
+}
+
+RangeAnalyzer::RangeAnalyzer(bool verbose, DiagnosticStreams diagnostics) : verbose(verbose), diagnostics(diagnostics) {}
+
+void RangeAnalyzer::analyze(ProgramNode* program) {
+    variable_ranges.clear();
+    widened_expressions = 0;
+    narrowed_literals = 0;
+
+    for (const auto& stmt : program->statements) {
+        visit(stmt.get());
+    }
+
+    if (verbose) {
+        *diagnostics.info << "Optimizer Info: Range inference kept " << narrowed_literals << " integer literal(s) as int and widened "
+                  << widened_expressions << " number expression(s) to lnumber" << std::endl;
+    }
+}
+
+bool RangeAnalyzer::fits_in_int(const ValueRange& range) {
+    return range.min >= INT_RANGE.min && range.max <= INT_RANGE.max;
+}
+
+bool RangeAnalyzer::always_overflows(const ValueRange& left, const ValueRange& right) {
+    return (right.min > 0 && left.min > LONG_LONG_RANGE.max - right.min) ||
+           (right.max < 0 && left.max < LONG_LONG_RANGE.min - right.max);
+}
+
+ValueRange RangeAnalyzer::add_ranges(const ValueRange& left, const ValueRange& right) {
+    // Saturate to the full long long range when the bounds themselves overflow
+    if ((right.min < 0 && left.min < LONG_LONG_RANGE.min - right.min) ||
+        (right.max > 0 && left.max > LONG_LONG_RANGE.max - right.max)) {
+        return LONG_LONG_RANGE;
+    }
+    return {left.min + right.min, left.max + right.max};
+}
+
+void RangeAnalyzer::visit(StatementNode* stmt) {
+    if (auto var_decl = dynamic_cast<VariableDeclarationNode*>(stmt)) {
+        visit(var_decl);
+    } else if (auto says_stmt = dynamic_cast<SaysStatementNode*>(stmt)) {
+        visit_and_get_range(says_stmt->expression.get());
+    } else if (auto if_stmt = dynamic_cast<IfStatementNode*>(stmt)) {
+        visit_and_get_range(if_stmt->condition.get());
+        visit(if_stmt->then_branch.get());
+        if (if_stmt->else_branch) {
+            visit(if_stmt->else_branch.get());
+        }
+    } else if (auto block_stmt = dynamic_cast<BlockStatementNode*>(stmt)) {
+        for (const auto& s : block_stmt->statements) {
+            visit(s.get());
+        }
+    }
+}
+
+void RangeAnalyzer::visit(VariableDeclarationNode* stmt) {
+    std::optional<ValueRange> init_range = visit_and_get_range(stmt->expression.get());
+    if (!init_range) return;
+
+    if (stmt->var_type == HScriptType::NUMBER) {
+        if (!fits_in_int(*init_range)) {
+            *diagnostics.warnings << "Range Warning: Initializer of number variable '" << stmt->identifier_name
+                      << "' may overflow int (possible values " << range_to_string(*init_range) << ")." << std::endl;
+            // The narrowed value could be anything an int can hold
+            variable_ranges[stmt->identifier_name] = INT_RANGE;
+            return;
+        }
+    } else if (stmt->var_type != HScriptType::LNUMBER) {
+        return; // riel variables are not tracked
+    }
+    variable_ranges[stmt->identifier_name] = *init_range;
+}
+
+std::optional<ValueRange> RangeAnalyzer::visit_and_get_range(ExprNode* expr) {
+    std::optional<ValueRange> range;
+    if (auto int_lit = dynamic_cast<IntegerLiteralNode*>(expr)) {
+        range = ValueRange{int_lit->value, int_lit->value};
+        if (fits_in_int(*range)) {
+            narrowed_literals++;
+        }
+    } else if (auto ident = dynamic_cast<IdentifierNode*>(expr)) {
+        auto it = variable_ranges.find(ident->name);
+        if (it != variable_ranges.end()) {
+            range = it->second;
+        } else if (is_integer_type(expr->expr_type)) {
+            range = expr->expr_type == HScriptType::NUMBER ? INT_RANGE : LONG_LONG_RANGE;
+        }
+    } else if (auto bin_op = dynamic_cast<BinaryOpNode*>(expr)) {
+        range = visit_and_get_range(bin_op);
+    }
+
+    if (!is_integer_type(expr->expr_type)) {
+        range.reset();
+    }
+    expr->value_range = range;
+    return range;
+}
+
+std::optional<ValueRange> RangeAnalyzer::visit_and_get_range(BinaryOpNode* root) {
+    // Walk the left spine iteratively so long left-leaning chains don't recurse per term
+    std::vector<BinaryOpNode*> spine;
+    ExprNode* node = root;
+    while (auto bin_op = dynamic_cast<BinaryOpNode*>(node)) {
+        spine.push_back(bin_op);
+        node = bin_op->left.get();
+    }
+
+    std::optional<ValueRange> left = visit_and_get_range(spine.back()->left.get());
+    std::optional<ValueRange> result;
+    for (size_t i = spine.size(); i-- > 0;) {
+        BinaryOpNode* expr = spine[i];
+        std::optional<ValueRange> right = visit_and_get_range(expr->right.get());
+        result = range_of_sum(expr, left, right);
+        if (i > 0) {
+            // Inner nodes are annotated here; the root is annotated by the caller
+            expr->value_range = is_integer_type(expr->expr_type) ? result : std::nullopt;
+            left = expr->value_range;
+        }
+    }
+    return result;
+}
+
+std::optional<ValueRange> RangeAnalyzer::range_of_sum(BinaryOpNode* expr, const std::optional<ValueRange>& left, const std::optional<ValueRange>& right) {
+    if (expr->op_token.type != TokenType::PLUS || !left || !right || !is_integer_type(expr->expr_type)) {
+        return std::nullopt;
+    }
+
+    if (always_overflows(*left, *right)) {
+        // Even the operands' closest values leave long long, so the generated code overflows
+        *diagnostics.warnings << "Range Warning: '" << expr->to_string() << "' always overflows lnumber (operands "
+                  << range_to_string(*left) << " and " << range_to_string(*right) << ")." << std::endl;
+    }
+    ValueRange sum = add_ranges(*left, *right);
+    bool operand_widened = expr->left->expr_type == HScriptType::LNUMBER || expr->right->expr_type == HScriptType::LNUMBER;
+    if (expr->expr_type == HScriptType::NUMBER && (!fits_in_int(sum) || operand_widened)) {
+        // int + int would overflow in the generated code; compute it in long long instead
+        expr->expr_type = HScriptType::LNUMBER;
+        widened_expressions++;
+        if (verbose) {
+            *diagnostics.info << "Optimizer Info: Widened '" << expr->to_string() << "' to lnumber (possible values "
+                      << range_to_string(sum) << ")" << std::endl;
+        }
+    }
+    return sum;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "ast.h"
+#include "diagnostics.h"
+#include <string>
+#include <unordered_map>
+
+// Tracks the possible range of every integer expression and picks the narrowest
+// C++ type that can hold it. 'number' arithmetic whose range may leave int is
+// widened to lnumber so the generated code computes it in long long; 'number'
+// initializers that may still overflow int on store, and sums that overflow long long
+// for every possible operand value, are reported as warnings.
+class RangeAnalyzer {
+public:
+    explicit RangeAnalyzer(bool verbose = false, DiagnosticStreams diagnostics = {});
+    void analyze(ProgramNode* program);
+
+    size_t widened_expression_count() const { return widened_expressions; }
+    size_t narrowed_literal_count() const { return narrowed_literals; }
+
+private:
+    bool verbose;
+    DiagnosticStreams diagnostics;
+    std::unordered_map<std::string, ValueRange> variable_ranges;
+    size_t widened_expressions = 0;
+    size_t narrowed_literals = 0;
+
+    void visit(StatementNode* stmt);
+    void visit(VariableDeclarationNode* stmt);
+
+    // Annotates 'expr' (and its children) with value_range; returns the range if 'expr' is an integer
+    std::optional<ValueRange> visit_and_get_range(ExprNode* expr);
+    std::optional<ValueRange> visit_and_get_range(BinaryOpNode* expr);
+    std::optional<ValueRange> range_of_sum(BinaryOpNode* expr, const std::optional<ValueRange>& left, const std::optional<ValueRange>& right);
+
+    static bool fits_in_int(const ValueRange& range);
+    static bool always_overflows(const ValueRange& left, const ValueRange& right);
+    static ValueRange add_ranges(const ValueRange& left, const ValueRange& right);
+};
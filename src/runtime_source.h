@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+// Text of runtime/humanscript_runtime.h followed by runtime/humanscript_runtime.cpp,
+// embedded at build time so generated programs can stay self-contained
+extern const char HUMANSCRIPT_RUNTIME_SOURCE[];
+// Length of the header part of HUMANSCRIPT_RUNTIME_SOURCE; the implementation follows it
+extern const size_t HUMANSCRIPT_RUNTIME_HEADER_SIZE;
+
+// Text of runtime/humanscript_c_runtime.h, embedded into programs generated with --emit=c
+extern const char HUMANSCRIPT_C_RUNTIME_SOURCE[];
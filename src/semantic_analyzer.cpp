@@ -1,13 +1,14 @@
 #include "semantic_analyzer.h"
 #include <iostream> 
+#include <limits>
 
-SemanticAnalyzer::SemanticAnalyzer() {}
+SemanticAnalyzer::SemanticAnalyzer(DiagnosticStreams diagnostics) : diagnostics(diagnostics) {}
 
 void SemanticAnalyzer::analyze(const ProgramNode* program) {
     symbol_table.clear(); 
 
     for (const auto& use_decl : program->use_declarations) {
-        std::cout << "Semantic Info: Processing 'use <" << use_decl->header_name << ">;' declaration." << std::endl;
+        *diagnostics.info << "Semantic Info: Processing 'use <" << use_decl->header_name << ">;' declaration." << std::endl;
     }
 
     for (const auto& stmt : program->statements) {
@@ -45,7 +46,7 @@ void SemanticAnalyzer::visit(const VariableDeclarationNode* stmt) {
     }
     
     symbol_table.emplace(var_name, Symbol(var_name, stmt->var_type));
-    std::cout << "Semantic Info: Declared variable '" << var_name << "' of type " << hscript_type_to_string(stmt->var_type) << std::endl;
+    *diagnostics.info << "Semantic Info: Declared variable '" << var_name << "' of type " << hscript_type_to_string(stmt->var_type) << std::endl;
 }
 
 void SemanticAnalyzer::visit(const SaysStatementNode* stmt) {
@@ -54,7 +55,7 @@ void SemanticAnalyzer::visit(const SaysStatementNode* stmt) {
         throw std::runtime_error("Semantic Error: 'says' statement cannot print an expression of type void or unknown.");
     }
     
-    std::cout << "Semantic Info: 'says' statement with expression of type " << hscript_type_to_string(expr_type) << std::endl;
+    *diagnostics.info << "Semantic Info: 'says' statement with expression of type " << hscript_type_to_string(expr_type) << std::endl;
 }
 
 void SemanticAnalyzer::visit(const IfStatementNode* stmt) {
@@ -74,7 +75,7 @@ void SemanticAnalyzer::visit(const IfStatementNode* stmt) {
         visit(stmt->else_branch.get());
     }
     
-    std::cout << "Semantic Info: Processed if statement" << std::endl;
+    *diagnostics.info << "Semantic Info: Processed if statement" << std::endl;
 }
 
 void SemanticAnalyzer::visit(const BlockStatementNode* stmt) {
@@ -86,7 +87,7 @@ void SemanticAnalyzer::visit(const BlockStatementNode* stmt) {
         visit(s.get());
     }
     
-    std::cout << "Semantic Info: Processed block statement" << std::endl;
+    *diagnostics.info << "Semantic Info: Processed block statement" << std::endl;
 }
 
 HScriptType SemanticAnalyzer::visit_and_get_type(const ExprNode* expr_const) {
@@ -111,7 +112,11 @@ HScriptType SemanticAnalyzer::visit_and_get_type(const ExprNode* expr_const) {
 }
 
 HScriptType SemanticAnalyzer::visit_and_get_type(const IntegerLiteralNode* expr) {
-    return HScriptType::LNUMBER; 
+    // Literals take the narrowest type that holds them, like the lexer's int / long long split
+    if (expr->value >= std::numeric_limits<int>::min() && expr->value <= std::numeric_limits<int>::max()) {
+        return HScriptType::NUMBER;
+    }
+    return HScriptType::LNUMBER;
 }
 
 HScriptType SemanticAnalyzer::visit_and_get_type(const DoubleLiteralNode* expr) {
@@ -136,19 +141,29 @@ HScriptType SemanticAnalyzer::visit_and_get_type(const IdentifierNode* expr) {
 }
 
 HScriptType SemanticAnalyzer::visit_and_get_type(const BinaryOpNode* expr_const) {
-     BinaryOpNode* expr = const_cast<BinaryOpNode*>(expr_const); 
-
-    HScriptType left_type = visit_and_get_type(expr->left.get());
-    HScriptType right_type = visit_and_get_type(expr->right.get());
-    TokenType op_type = expr->op_token.type;
+    // Walk the left spine iteratively so long left-leaning chains don't recurse per term
+    std::vector<BinaryOpNode*> spine;
+    ExprNode* node = const_cast<BinaryOpNode*>(expr_const);
+    while (auto bin_op = dynamic_cast<BinaryOpNode*>(node)) {
+        spine.push_back(bin_op);
+        node = bin_op->left.get();
+    }
 
-    expr->expr_type = get_binary_op_result_type(left_type, right_type, op_type);
-    if (expr->expr_type == HScriptType::UNKNOWN) {
-        throw std::runtime_error("Semantic Error: Invalid operands for binary operator '" + expr->op_token.text +
-                                 "'. Left type: " + hscript_type_to_string(left_type) +
-                                 ", Right type: " + hscript_type_to_string(right_type) + ".");
+    HScriptType left_type = visit_and_get_type(spine.back()->left.get());
+    for (size_t i = spine.size(); i-- > 0;) {
+        BinaryOpNode* expr = spine[i];
+        HScriptType right_type = visit_and_get_type(expr->right.get());
+        TokenType op_type = expr->op_token.type;
+
+        expr->expr_type = get_binary_op_result_type(left_type, right_type, op_type);
+        if (expr->expr_type == HScriptType::UNKNOWN) {
+            throw std::runtime_error("Semantic Error: Invalid operands for binary operator '" + expr->op_token.text +
+                                     "'. Left type: " + hscript_type_to_string(left_type) +
+                                     ", Right type: " + hscript_type_to_string(right_type) + ".");
+        }
+        left_type = expr->expr_type;
     }
-    return expr->expr_type;
+    return left_type;
 }
 
 bool SemanticAnalyzer::is_assignable(HScriptType target_type, HScriptType value_type) {
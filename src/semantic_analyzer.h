@@ -1,5 +1,6 @@
 #pragma once
 #include "ast.h"
+#include "diagnostics.h"
 #include <string>
 #include <unordered_map> 
 #include <stdexcept>     
@@ -15,10 +16,11 @@ struct Symbol {
 
 class SemanticAnalyzer {
 public:
-    SemanticAnalyzer();
+    explicit SemanticAnalyzer(DiagnosticStreams diagnostics = {});
     void analyze(const ProgramNode* program);
 
 private:
+    DiagnosticStreams diagnostics;
     std::unordered_map<std::string, Symbol> symbol_table;
     
     void visit(const StatementNode* stmt);
@@ -0,0 +1,173 @@
+#include "toolchain.h"
+#include "cache_directory.h"
+#include "hash.h"
+#include "process.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#if defined(_WIN32) || defined(_WIN64)
+constexpr char PATH_SEPARATOR = ';';
+const char* const EXECUTABLE_SUFFIXES[] = {".exe", ""};
+#else
+constexpr char PATH_SEPARATOR = ':';
+const char* const EXECUTABLE_SUFFIXES[] = {""};
+#endif
+
+bool is_executable_file(const fs::path& path) {
+    std::error_code error;
+    if (!fs::is_regular_file(path, error)) return false; // Follows symlinks
+    #ifdef _WIN32
+    return true;
+    #else
+    return access(path.c_str(), X_OK) == 0;
+    #endif
+}
+
+// First executable called 'name' in $PATH, or an empty path
+fs::path search_path(const std::string& name) {
+    const char* path_variable = std::getenv("PATH");
+    if (!path_variable) return {};
+    std::string_view remaining = path_variable;
+    while (true) {
+        size_t separator = remaining.find(PATH_SEPARATOR);
+        std::string_view entry = remaining.substr(0, separator);
+        fs::path directory = entry.empty() ? fs::path(".") : fs::path(entry);
+        for (const char* suffix : EXECUTABLE_SUFFIXES) {
+            fs::path candidate = directory / (name + suffix);
+            if (is_executable_file(candidate)) return fs::absolute(candidate);
+        }
+        if (separator == std::string_view::npos) return {};
+        remaining.remove_prefix(separator + 1);
+    }
+}
+
+fs::path resolve(const std::string& name) {
+    if (name.find('/') != std::string::npos || name.find('\\') != std::string::npos) {
+        return is_executable_file(name) ? fs::absolute(name) : fs::path();
+    }
+    return search_path(name);
+}
+
+bool is_msvc_driver(const fs::path& path) {
+    std::string stem = path.stem().string();
+    return stem == "cl" || stem == "CL";
+}
+
+// Fingerprint of the binary the descriptor was probed from; a reinstalled or upgraded
+// compiler changes it. Symlinks (g++ -> g++-12) are followed.
+std::string binary_fingerprint(const fs::path& path) {
+    std::error_code error;
+    auto modified = fs::last_write_time(path, error);
+    if (error) return "";
+    auto size = fs::file_size(path, error);
+    if (error) return "";
+    return std::to_string(static_cast<long long>(modified.time_since_epoch().count())) + " " + std::to_string(size);
+}
+
+// Descriptor layout: a header line, the fingerprint, "clang 0|1", then the version text
+constexpr const char* DESCRIPTOR_HEADER = "humanscript-toolchain 1";
+
+bool read_descriptor(const fs::path& file, const std::string& fingerprint, Toolchain& toolchain) {
+    std::ifstream in(file, std::ios::binary);
+    std::string header, stored_fingerprint, clang;
+    if (!std::getline(in, header) || header != DESCRIPTOR_HEADER) return false;
+    if (!std::getline(in, stored_fingerprint) || stored_fingerprint != fingerprint) return false;
+    if (!std::getline(in, clang) || (clang != "clang 0" && clang != "clang 1")) return false;
+    std::ostringstream version;
+    version << in.rdbuf();
+    toolchain.is_clang = clang == "clang 1";
+    toolchain.version = version.str();
+    return !toolchain.version.empty();
+}
+
+void write_descriptor(const fs::path& file, const std::string& fingerprint, const Toolchain& toolchain) {
+    // Written under a temporary name and renamed, so a concurrent run never reads half a file
+    fs::path temp = file;
+    #ifdef _WIN32
+    temp += ".tmp";
+    #else
+    temp += ".tmp" + std::to_string(static_cast<long long>(getpid()));
+    #endif
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << DESCRIPTOR_HEADER << '\n' << fingerprint << '\n'
+            << "clang " << (toolchain.is_clang ? 1 : 0) << '\n' << toolchain.version;
+        if (!out) return;
+    }
+    std::error_code error;
+    fs::rename(temp, file, error);
+    if (error) fs::remove(temp, error);
+}
+
+void describe(Toolchain& toolchain) {
+    if (toolchain.is_msvc) return; // cl prints its banner on stderr and has no --version
+
+    std::string fingerprint = binary_fingerprint(toolchain.path);
+    std::string cache_directory = humanscript_cache_directory();
+    fs::path descriptor;
+    if (!fingerprint.empty() && !cache_directory.empty()) {
+        descriptor = fs::path(cache_directory) / ("toolchain-" + Fnv1aHash().add(toolchain.path).hex());
+        if (read_descriptor(descriptor, fingerprint, toolchain)) return;
+    }
+
+    std::ostringstream version, ignored;
+    if (!run_process({toolchain.path, "--version"}, "", version, ignored).succeeded()) return;
+    toolchain.version = version.str();
+    toolchain.is_clang = toolchain.version.find("clang") != std::string::npos;
+    if (!descriptor.empty() && !toolchain.version.empty()) {
+        write_descriptor(descriptor, fingerprint, toolchain);
+    }
+}
+
+} // namespace
+
+Toolchain find_toolchain(SourceLanguage language, const std::string& override_name) {
+    bool cpp = language == SourceLanguage::CPP;
+    std::string requested = override_name;
+    const char* variable = cpp ? "HUMANSCRIPT_CXX" : "HUMANSCRIPT_CC";
+    if (requested.empty()) {
+        if (const char* value = std::getenv(variable); value && *value) {
+            requested = value;
+        }
+    }
+
+    fs::path found;
+    if (!requested.empty()) {
+        found = resolve(requested);
+        if (found.empty()) {
+            throw std::runtime_error("Toolchain Error: Compiler '" + requested + "' was not found or is not executable");
+        }
+    } else {
+        #if defined(_WIN32) || defined(_WIN64)
+        std::vector<std::string> candidates = cpp ? std::vector<std::string>{"g++", "clang++", "cl"} : std::vector<std::string>{"gcc", "clang", "cl"};
+        #else
+        std::vector<std::string> candidates = cpp ? std::vector<std::string>{"clang++", "g++", "c++"} : std::vector<std::string>{"clang", "gcc", "cc"};
+        #endif
+        for (const auto& candidate : candidates) {
+            found = search_path(candidate);
+            if (!found.empty()) break;
+        }
+        if (found.empty()) {
+            throw std::runtime_error(std::string("Toolchain Error: No ") + (cpp ? "C++" : "C") + " compiler found in PATH (set " +
+                                     (cpp ? "--cxx= or " : "--cc= or ") + variable + ")");
+        }
+    }
+
+    Toolchain toolchain;
+    toolchain.is_msvc = is_msvc_driver(found);
+    toolchain.path = toolchain.is_msvc ? "cl" : found.string();
+    describe(toolchain);
+    return toolchain;
+}
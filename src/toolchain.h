@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+enum class SourceLanguage { CPP, C };
+
+// A backend compiler driver found for -run
+struct Toolchain {
+    std::string path;    // Absolute path of the driver ("cl" for MSVC, which is left to PATH)
+    std::string version; // Full '--version' output; empty when unknown (cl has none)
+    bool is_clang = false;
+    bool is_msvc = false;
+};
+
+// Locates the compiler for 'language' without executing anything: 'override_name' (from
+// --cxx=/--cc=), else $HUMANSCRIPT_CXX/$HUMANSCRIPT_CC, else the first of clang++, g++, c++
+// (clang, gcc, cc for C) found in PATH. A name without a slash is looked up in PATH.
+// The version is read from a descriptor cached under humanscript_cache_directory() and only
+// probed with '--version' when the binary's modification time or size changed.
+// Throws std::runtime_error when no compiler is found.
+Toolchain find_toolchain(SourceLanguage language, const std::string& override_name);
@@ -0,0 +1,116 @@
+#include "watch.h"
+
+#ifdef __linux__
+#include "hash.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <poll.h>
+#include <sstream>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+// SHA-256 of the file's contents, since a collision would silently skip a rebuild; empty
+// when it cannot be read (e.g. mid-rename)
+std::string content_hash(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return "";
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return Sha256Hash().add(buffer.str()).hex();
+}
+
+// Splits 'path' into the directory to watch and the name events are matched against
+void split_path(const std::string& path, std::string& directory, std::string& name) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        directory = ".";
+        name = path;
+    } else {
+        directory = slash == 0 ? "/" : path.substr(0, slash);
+        name = path.substr(slash + 1);
+    }
+}
+
+// Reads the pending events and sets 'relevant' when one of them concerns 'name'. Returns
+// false with errno set when reading fails.
+bool read_events(int inotify_fd, const std::string& name, bool& relevant) {
+    alignas(inotify_event) char buffer[sizeof(inotify_event) + NAME_MAX + 1];
+    for (;;) {
+        ssize_t length = read(inotify_fd, buffer, sizeof buffer);
+        if (length < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN;
+        }
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            auto* event = reinterpret_cast<inotify_event*>(cursor);
+            if ((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && name == event->name)) {
+                relevant = true;
+            }
+            cursor += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+
+// Blocks until 'name' has changed and then stayed quiet for WATCH_DEBOUNCE_MS
+bool wait_for_change(int inotify_fd, const std::string& name) {
+    bool changed = false;
+    int timeout = -1;
+    for (;;) {
+        pollfd descriptor{inotify_fd, POLLIN, 0};
+        int ready = poll(&descriptor, 1, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (ready == 0) return true; // Quiet since the last event
+        if (!read_events(inotify_fd, name, changed)) return false;
+        if (changed) timeout = WATCH_DEBOUNCE_MS;
+    }
+}
+
+} // namespace
+
+int watch_file(const std::string& input_filename, const DriverOptions& options, CompileContext context, std::ostream& out, std::ostream& err) {
+    std::string directory, name;
+    split_path(input_filename, directory, name);
+    int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0 || inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+        err << "Error: Cannot watch '" << directory << "': " << std::strerror(errno) << std::endl;
+        if (inotify_fd >= 0) close(inotify_fd);
+        return 1;
+    }
+
+    std::string previous_code;
+    context.previous_code = &previous_code;
+    std::string compiled_hash = content_hash(input_filename);
+    compile_file(input_filename, options, context, out, err);
+    for (;;) {
+        out << "\nWatching " << input_filename << " for changes (Ctrl+C to stop)..." << std::endl;
+        std::string hash;
+        do {
+            if (!wait_for_change(inotify_fd, name)) {
+                err << "Error: Watching '" << input_filename << "' failed: " << std::strerror(errno) << std::endl;
+                close(inotify_fd);
+                return 1;
+            }
+            hash = content_hash(input_filename);
+        } while (hash.empty() || hash == compiled_hash); // Deleted, or saved without changes
+
+        compiled_hash = hash;
+        out << "\n" << input_filename << " changed; recompiling\n" << std::endl;
+        compile_file(input_filename, options, context, out, err);
+    }
+}
+
+#else
+
+int watch_file(const std::string&, const DriverOptions&, CompileContext, std::ostream&, std::ostream& err) {
+    err << "Error: --watch needs inotify, which this platform does not provide" << std::endl;
+    return 1;
+}
+
+#endif
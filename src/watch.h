@@ -0,0 +1,14 @@
+#pragma once
+#include "driver.h"
+#include <ostream>
+#include <string>
+
+// --watch: compiles 'input_filename' (and runs it under -run) now and again every time it is
+// saved, until interrupted. Change notifications come from inotify on the file's directory,
+// so editors that save by renaming a new file into place are seen too; a burst of events is
+// handled once, after WATCH_DEBOUNCE_MS without further changes. Saves that leave the source
+// as it was are skipped, analyses come from 'context.analysis_cache', and generated code
+// identical to the previous build is not written again. Returns only when watching fails.
+int watch_file(const std::string& input_filename, const DriverOptions& options, CompileContext context, std::ostream& out, std::ostream& err);
+
+constexpr int WATCH_DEBOUNCE_MS = 50;
@@ -0,0 +1,50 @@
+# Checks where -run caches executables and that it never trusts a cache directory other
+# users could have planted files in:
+#   - with HOME, XDG_CACHE_HOME and HUMANSCRIPT_CACHE_DIR unset, the cache is a per-user
+#     directory under TMPDIR created with mode 0700
+#   - a HUMANSCRIPT_CACHE_DIR writable by others turns caching off
+#
+# Expects -DCOMPILER=<path> -DWORK_DIR=<dir>. POSIX only.
+
+foreach(required COMPILER WORK_DIR)
+    if(NOT DEFINED ${required})
+        message(FATAL_ERROR "cache_directory.cmake needs -D${required}=...")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/tmp" "${WORK_DIR}/shared")
+file(WRITE "${WORK_DIR}/cached.hs" "says \"cached\";\n")
+
+# Runs cached.hs with the environment changes in ARGN and checks that the program ran
+function(run_cached)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E env ${ARGN} "${COMPILER}" cached.hs --no-server -run
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE status
+        OUTPUT_VARIABLE stdout
+        ERROR_VARIABLE stderr
+    )
+    string(FIND "${stdout}" "\ncached\n" position)
+    if(NOT status STREQUAL "0" OR position EQUAL -1)
+        message(FATAL_ERROR "cached.hs did not run (status '${status}'):\n${stdout}${stderr}")
+    endif()
+endfunction()
+
+execute_process(COMMAND id -u OUTPUT_VARIABLE uid OUTPUT_STRIP_TRAILING_WHITESPACE)
+run_cached(--unset=HOME --unset=XDG_CACHE_HOME --unset=HUMANSCRIPT_CACHE_DIR "TMPDIR=${WORK_DIR}/tmp")
+set(fallback "${WORK_DIR}/tmp/humanscript-cache-${uid}")
+if(NOT IS_DIRECTORY "${fallback}/exe")
+    message(FATAL_ERROR "Without HOME the cache should be ${fallback}")
+endif()
+execute_process(COMMAND ls -ld "${fallback}" OUTPUT_VARIABLE listing)
+if(NOT listing MATCHES "^drwx------")
+    message(FATAL_ERROR "${fallback} should be private to its owner:\n${listing}")
+endif()
+
+execute_process(COMMAND chmod 777 "${WORK_DIR}/shared")
+run_cached("HUMANSCRIPT_CACHE_DIR=${WORK_DIR}/shared")
+file(GLOB planted_entries "${WORK_DIR}/shared/*")
+if(planted_entries)
+    message(FATAL_ERROR "A world-writable cache directory was used:\n${planted_entries}")
+endif()
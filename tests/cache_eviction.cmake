@@ -0,0 +1,46 @@
+# Checks that the executable cache evicts the least recently used entries once it grows
+# past $HUMANSCRIPT_CACHE_LIMIT_MB. With a limit of 0 only the entry just published
+# survives, and a later run of it is still a hit.
+#
+# Expects -DCOMPILER=<path> -DWORK_DIR=<dir>.
+
+foreach(required COMPILER WORK_DIR)
+    if(NOT DEFINED ${required})
+        message(FATAL_ERROR "cache_eviction.cmake needs -D${required}=...")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(WRITE "${WORK_DIR}/first.hs" "says \"first\";\n")
+file(WRITE "${WORK_DIR}/second.hs" "says \"second\";\n")
+
+# Runs 'program' against a private cache and stores the compiler's stdout in 'result'
+function(run_with_limit program result)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E env "HUMANSCRIPT_CACHE_DIR=${WORK_DIR}/cache" HUMANSCRIPT_CACHE_LIMIT_MB=0
+            "${COMPILER}" ${program} --no-server -run
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE status
+        OUTPUT_VARIABLE stdout
+        ERROR_VARIABLE stderr
+    )
+    if(NOT status STREQUAL "0")
+        message(FATAL_ERROR "${program} failed (status '${status}'):\n${stdout}${stderr}")
+    endif()
+    set(${result} "${stdout}" PARENT_SCOPE)
+endfunction()
+
+run_with_limit(first.hs unused)
+run_with_limit(second.hs unused)
+file(GLOB entries "${WORK_DIR}/cache/exe/*")
+list(LENGTH entries entry_count)
+if(NOT entry_count EQUAL 1)
+    message(FATAL_ERROR "Expected only the newest entry to survive, found:\n${entries}")
+endif()
+
+run_with_limit(second.hs output)
+string(FIND "${output}" "Using cached executable:" hit)
+if(hit EQUAL -1)
+    message(FATAL_ERROR "The surviving entry was not reused:\n${output}")
+endif()
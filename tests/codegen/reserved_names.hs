@@ -0,0 +1,17 @@
+// Variables named like the runtime namespace, the chunk state, main() and a keyword, and
+// names with leading underscores, which must not come out with a reserved '__'
+// ARGS: -run
+// OUTPUT: h
+// OUTPUT: 5
+// OUTPUT: h3
+// OUTPUT: 7
+text hs := "h";
+number state := 2;
+number main := state + 1;
+text int := hs + main;
+says hs;
+says state + main;
+says int;
+number _x := 3;
+number __x := _x + 1;
+says _x + __x;
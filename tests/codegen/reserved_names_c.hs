@@ -0,0 +1,16 @@
+// The same names through the C backend
+// ARGS: -run --emit=c
+// OUTPUT: h
+// OUTPUT: 5
+// OUTPUT: h3
+// OUTPUT: 7
+text hs := "h";
+number state := 2;
+number main := state + 1;
+text int := hs + main;
+says hs;
+says state + main;
+says int;
+number _x := 3;
+number __x := _x + 1;
+says _x + __x;
@@ -0,0 +1,17 @@
+// The same names with every statement in its own chunk, so they are hoisted constants
+// and HsState members
+// ARGS: -run --chunk-size=1
+// OUTPUT: h
+// OUTPUT: 5
+// OUTPUT: h3
+// OUTPUT: 7
+text hs := "h";
+number state := 2;
+number main := state + 1;
+text int := hs + main;
+says hs;
+says state + main;
+says int;
+number _x := 3;
+number __x := _x + 1;
+says _x + __x;
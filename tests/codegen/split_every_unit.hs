@@ -0,0 +1,15 @@
+// The last chunk holds most of the statements, but with as many chunks as units each
+// unit still gets one
+// ARGS: --split-tu=3 --chunk-size=1
+// EXPECT: written to: split_every_unit_hs_generated.h split_every_unit_hs_generated_0.cpp split_every_unit_hs_generated_1.cpp split_every_unit_hs_generated_2.cpp
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+says wrapped;
+says c;
+if (c) {
+    says 1;
+    says 2;
+    says 3;
+    says 4;
+    says 5;
+}
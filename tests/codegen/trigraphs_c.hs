@@ -0,0 +1,9 @@
+// Trigraph sequences in text stay literal under -std=c99
+// ARGS: -run --emit=c --no-cache
+// OUTPUT: a??/
+// OUTPUT: b??!
+// OUTPUT: c??=
+text t := "a??/";
+says t;
+says "b??!";
+says "c??=";
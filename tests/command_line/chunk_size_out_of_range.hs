@@ -0,0 +1,5 @@
+// A chunk size too large for size_t is rejected like any other bad value
+// ARGS: --check --chunk-size=99999999999999999999999
+// STATUS: 1
+// EXPECT: Error: --chunk-size expects a number of statements, got '99999999999999999999999'
+says 1;
@@ -0,0 +1,5 @@
+// A job count too large for size_t is rejected like any other bad value
+// ARGS: --check -j99999999999999999999999
+// STATUS: 1
+// EXPECT: Error: -j expects a positive number of jobs, got '99999999999999999999999'
+says 1;
@@ -0,0 +1,5 @@
+// A unit count too large for size_t is rejected like any other bad value
+// ARGS: --check --split-tu=99999999999999999999999
+// STATUS: 1
+// EXPECT: Error: --split-tu expects a positive number of translation units, got '99999999999999999999999'
+says 1;
@@ -0,0 +1,5 @@
+// Zero units is rejected too
+// ARGS: --check --split-tu=0
+// STATUS: 1
+// EXPECT: Error: --split-tu expects a positive number of translation units, got '0'
+says 1;
@@ -0,0 +1,68 @@
+# Starts a compile server and checks that a forwarded invocation prints exactly what a
+# local one does when stdout and stderr go to the same place: informational messages
+# written before an error must still come before it. A server too busy to accept a request
+# (stopped here) must not hold the client up: it compiles locally instead.
+#
+# Expects -DCOMPILER=<path> -DWORK_DIR=<dir>. POSIX only.
+
+foreach(required COMPILER WORK_DIR)
+    if(NOT DEFINED ${required})
+        message(FATAL_ERROR "compile_server.cmake needs -D${required}=...")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+# Declares q (a Semantic Info line on stdout), then fails on zz (an error on stderr)
+file(WRITE "${WORK_DIR}/bad.hs" "number q := 1;\nsays q + zz;\n")
+set(socket "${WORK_DIR}/server.sock")
+
+execute_process(
+    COMMAND sh -c "\"$0\" --server \"--socket=$1\" >server.log 2>&1 & echo $!" "${COMPILER}" "${socket}"
+    WORKING_DIRECTORY "${WORK_DIR}"
+    OUTPUT_VARIABLE server_pid
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+foreach(attempt RANGE 100)
+    if(EXISTS "${socket}")
+        break()
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 0.1)
+endforeach()
+
+# Runs bad.hs with 'mode' and stores the merged output in 'result'
+function(run_merged mode result)
+    execute_process(
+        COMMAND sh -c "\"$0\" bad.hs -v -run \"$1\" 2>&1" "${COMPILER}" "${mode}"
+        WORKING_DIRECTORY "${WORK_DIR}"
+        OUTPUT_VARIABLE output
+        TIMEOUT 60
+    )
+    set(${result} "${output}" PARENT_SCOPE)
+endfunction()
+
+set(started FALSE)
+if(EXISTS "${socket}")
+    set(started TRUE)
+    run_merged("--socket=${socket}" forwarded)
+    execute_process(COMMAND kill -STOP "${server_pid}")
+    run_merged("--socket=${socket}" busy)
+endif()
+execute_process(COMMAND kill -KILL "${server_pid}")
+if(NOT started)
+    file(READ "${WORK_DIR}/server.log" server_log)
+    message(FATAL_ERROR "The compile server did not start:\n${server_log}")
+endif()
+
+run_merged("--no-server" local)
+if(NOT forwarded STREQUAL local)
+    message(FATAL_ERROR "Forwarded output differs from local output.\n--- forwarded ---\n${forwarded}--- local ---\n${local}")
+endif()
+if(NOT busy STREQUAL local)
+    message(FATAL_ERROR "Output with a busy server differs from local output.\n--- busy ---\n${busy}--- local ---\n${local}")
+endif()
+string(FIND "${local}" "Semantic Info: Declared variable 'q'" declared)
+string(FIND "${local}" "Compilation Error" failed)
+if(declared EQUAL -1 OR failed EQUAL -1 OR declared GREATER failed)
+    message(FATAL_ERROR "Expected the declaration before the error:\n${local}")
+endif()
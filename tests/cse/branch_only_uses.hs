@@ -0,0 +1,16 @@
+// Must not hoist: each use sits in a different branch, so a temporary would be computed on
+// paths that never needed it. 'wrapped' is 2^32 narrowed to int, which is 0, and only the
+// generated program computes it, so the if keeps its runtime test and takes the then branch.
+// ARGS: -v -run
+// REJECT: -Woverflow
+// EXPECT: Common subexpression elimination hoisted 0 expression(s)
+// OUTPUT: 6
+number a := 2;
+number b := 3;
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+if (c) {
+    says a + b + 1;
+} else {
+    says a + b;
+}
@@ -0,0 +1,18 @@
+// The use inside the branch stays there and the two after the if share a temporary. The
+// condition is false at run time (2^32 narrowed to int is 0, not 1), so this also checks that
+// the temporary does not depend on the skipped branch having run.
+// ARGS: -v -run
+// REJECT: -Woverflow
+// EXPECT: Hoisted '(a + b)' (used 2 times) into temporary 'hs_cse0'
+// EXPECT: Common subexpression elimination hoisted 1 expression(s)
+// OUTPUT: 5
+// OUTPUT: 5
+number a := 2;
+number b := 3;
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 1;
+if (c) {
+    says a + b;
+}
+says a + b;
+says a + b;
@@ -0,0 +1,18 @@
+// The first use runs on every path, so the temporary it introduces also serves the later
+// uses, including the one inside the branch the program takes at run time
+// ARGS: -v -run
+// REJECT: -Woverflow
+// EXPECT: Hoisted '(a + b)' (used 3 times) into temporary 'hs_cse0'
+// EXPECT: Common subexpression elimination hoisted 1 expression(s)
+// OUTPUT: 5
+// OUTPUT: 5
+// OUTPUT: 5
+number a := 2;
+number b := 3;
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+says a + b;
+if (c) {
+    says a + b;
+}
+says a + b;
@@ -0,0 +1,15 @@
+// The first use is the whole initializer of a variable that is never reassigned, so the
+// later uses read that variable instead of copying a temporary into it
+// ARGS: -v -run
+// EXPECT: Reused variable 't' for '((s + n) + "y")' (used 3 times)
+// REJECT: hs_cse0
+// OUTPUT: x4y
+// OUTPUT: x4y!
+// OUTPUT: x4y
+text s := "x";
+number n := 4;
+text t := s + n + "y";
+text u := s + n + "y";
+says t;
+says u + "!";
+says s + n + "y";
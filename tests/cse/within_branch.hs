@@ -0,0 +1,15 @@
+// Both uses are inside the same branch, so the temporary is declared there and is only
+// computed when the program takes that branch at run time
+// ARGS: -v -run
+// REJECT: -Woverflow
+// EXPECT: Hoisted '(a + b)' (used 2 times) into temporary 'hs_cse0'
+// OUTPUT: 5
+// OUTPUT: 6
+number a := 2;
+number b := 3;
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+if (c) {
+    says a + b;
+    says a + b + 1;
+}
@@ -0,0 +1,11 @@
+// A comparison that folds to false keeps only the else branch
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Condition '(n ?= 2)' is always false; eliminated then branch
+// EXPECT: Dead-branch elimination removed 1 branch(es)
+// OUTPUT: else
+number n := 1;
+if (n ?= 2) {
+    says "then";
+} else {
+    says "else";
+}
@@ -0,0 +1,11 @@
+// A condition that folds to true keeps only the then branch
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Condition 'on' is always true; eliminated else branch
+// EXPECT: Dead-branch elimination removed 1 branch(es)
+// OUTPUT: then
+logic on := true;
+if (on) {
+    says "then";
+} else {
+    says "else";
+}
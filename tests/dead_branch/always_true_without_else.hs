@@ -0,0 +1,8 @@
+// Without an else nothing is removed but the test itself; that is not counted as a branch
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Condition 'true' is always true; eliminated runtime test
+// EXPECT: Dead-branch elimination removed 0 branch(es)
+// OUTPUT: then
+if (true) {
+    says "then";
+}
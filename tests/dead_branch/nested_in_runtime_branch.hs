@@ -0,0 +1,16 @@
+// The outer test depends on 'wrapped', which only the program computes (2^32 narrowed to
+// int is 0), so it stays; the constant if inside its then branch is still eliminated
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Condition 'false' is always false; eliminated then branch
+// EXPECT: Dead-branch elimination removed 1 branch(es)
+// REJECT: Condition 'c' is always
+// OUTPUT: inner else
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+if (c) {
+    if (false) {
+        says "inner then";
+    } else {
+        says "inner else";
+    }
+}
@@ -0,0 +1,13 @@
+// A riel variable holds its integer initializer rounded to double, so the comparison
+// and the concatenation see 9007199254740992 like the program does
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Condition '(r ?= 9007199254740992)' is always true; eliminated else branch
+// OUTPUT: eq
+// OUTPUT: 9007199254740992
+riel r := 9007199254740993;
+if (r ?= 9007199254740992) {
+    says "eq";
+} else {
+    says "ne";
+}
+says "" + r;
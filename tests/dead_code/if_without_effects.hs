@@ -0,0 +1,11 @@
+// An if whose branches only declared variables nobody reads is removed once they are
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Removed unused variable 'inner'
+// EXPECT: Optimizer Info: Removed if statement without effects
+// OUTPUT: after
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+if (c) {
+    number inner := 1;
+}
+says "after";
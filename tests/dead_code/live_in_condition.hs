@@ -0,0 +1,10 @@
+// Must not remove: an if condition reads 'c', even though neither branch reads anything.
+// 'wrapped' (2^32 narrowed to int, 0 at run time) keeps the test from folding away.
+// ARGS: -v -run
+// REJECT: Removed unused variable 'c'
+// OUTPUT: zero
+number wrapped := 2147483647 + 2147483647 + 2;
+logic c := wrapped ?= 0;
+if (c) {
+    says "zero";
+}
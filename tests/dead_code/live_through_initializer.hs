@@ -0,0 +1,8 @@
+// Must not remove: 'a' is read by the initializer of 'b', which a 'says' reads
+// ARGS: -v -run
+// EXPECT: Dead-code elimination removed 0 unused variable(s)
+// REJECT: Removed unused variable
+// OUTPUT: xy
+text a := "x";
+text b := a + "y";
+says b;
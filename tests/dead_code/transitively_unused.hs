@@ -0,0 +1,9 @@
+// 'a' is only read by the initializer of 'b', which is itself never read, so both go
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Removed unused variable 'a'
+// EXPECT: Optimizer Info: Removed unused variable 'b'
+// EXPECT: Dead-code elimination removed 2 unused variable(s)
+// OUTPUT: hi
+text a := "x";
+text b := a + "y";
+says "hi";
@@ -0,0 +1,7 @@
+// A variable nothing reads is removed
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Removed unused variable 'unused'
+// EXPECT: Dead-code elimination removed 1 unused variable(s)
+// OUTPUT: hi
+number unused := 1;
+says "hi";
@@ -0,0 +1,39 @@
+# Generates one statement that concatenates TERMS operands in a single left-leaning
+# chain and runs it through the front end and both backends. Every pass walks such
+# chains in a loop, so this must finish instead of overflowing the stack.
+#
+# Expects -DCOMPILER=<path> -DWORK_DIR=<dir> -DTERMS=<multiple of 100>.
+
+foreach(required COMPILER WORK_DIR TERMS)
+    if(NOT DEFINED ${required})
+        message(FATAL_ERROR "deep_chain.cmake needs -D${required}=...")
+    endif()
+endforeach()
+
+# Alternate text and number operands so nothing folds and every term reaches the backend
+set(hundred_terms "")
+foreach(i RANGE 1 50)
+    string(APPEND hundred_terms " + x + n")
+endforeach()
+math(EXPR hundreds "${TERMS} / 100")
+set(chain "x")
+foreach(i RANGE 1 ${hundreds})
+    string(APPEND chain "${hundred_terms}")
+endforeach()
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(WRITE "${WORK_DIR}/deep_chain.hs" "text x := \"a\";\nnumber n := 1;\nsays ${chain};\n")
+
+# Without -run the compiler stops once the generated code is written
+foreach(mode "--check" "--emit=cpp" "--emit=c")
+    execute_process(
+        COMMAND "${COMPILER}" deep_chain.hs --no-server ${mode}
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE status
+        OUTPUT_VARIABLE stdout
+        ERROR_VARIABLE stderr
+    )
+    if(NOT status STREQUAL "0")
+        message(FATAL_ERROR "A ${TERMS}-term chain failed with ${mode} (status '${status}'):\n${stdout}${stderr}")
+    endif()
+endforeach()
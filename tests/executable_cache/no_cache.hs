@@ -0,0 +1,8 @@
+// With the cache off the executable is linked into memory and run from there, so the
+// working directory gets no .cpp and no executable
+// ARGS: -run --no-cache
+// EXPECT: Executable: (in memory)
+// REJECT: Using cached executable
+// LEAVES: nothing
+// OUTPUT: not cached
+says "not cached";
@@ -0,0 +1,8 @@
+// The second -run of an unchanged program reuses the executable the first one cached
+// ARGS: -run
+// RUNS: 2
+// EXPECT: Using cached executable:
+// REJECT: Compiling generated C++ code
+// LEAVES: nothing
+// OUTPUT: cached
+says "cached";
@@ -0,0 +1,6 @@
+// Must not warn: the sum reaches the largest long long but stays inside it
+// ARGS: -run
+// REJECT: always overflows
+// OUTPUT: 9223372036854775807
+lnumber big := 9223372036854775806;
+says big + 1;
@@ -0,0 +1,5 @@
+// An lnumber sum that leaves long long for every possible operand value is reported
+// ARGS: --check
+// EXPECT: Range Warning: '(big + 1)' always overflows lnumber (operands 9223372036854775807 and 1).
+lnumber big := 9223372036854775807;
+says big + 1;
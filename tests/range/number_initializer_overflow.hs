@@ -0,0 +1,8 @@
+// A number initializer that cannot fit in int is reported, and the program stores it
+// narrowed to int
+// ARGS: -run
+// EXPECT: Range Warning: Initializer of number variable 'w' may overflow int (possible values 2147483648).
+// REJECT: -Woverflow
+// OUTPUT: -2147483648
+number w := 2147483647 + 1;
+says w;
@@ -0,0 +1,6 @@
+// A literal that fits in int is typed number, so it can initialize a number variable
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Range inference kept 2 integer literal(s) as int
+// OUTPUT: 6
+number x := 5;
+says x + 1;
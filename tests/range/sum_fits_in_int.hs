@@ -0,0 +1,8 @@
+// Must not widen: the sum of these numbers always fits in int
+// ARGS: -v -run
+// EXPECT: widened 0 number expression(s) to lnumber
+// REJECT: Widened
+// OUTPUT: 3
+number a := 1;
+number b := 2;
+says a + b;
@@ -0,0 +1,8 @@
+// number + number that may leave int is computed in long long and prints the full sum
+// ARGS: -v -run
+// EXPECT: Optimizer Info: Widened '(a + b)' to lnumber (possible values 4000000000)
+// EXPECT: widened 1 number expression(s) to lnumber
+// OUTPUT: 4000000000
+number a := 2000000000;
+number b := 2000000000;
+says a + b;
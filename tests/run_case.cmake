@@ -0,0 +1,124 @@
+# Runs one test case through the compiler and checks it against the directives in
+# the case's own // comments:
+#   // ARGS: <arguments>   compiler arguments after the input file (default: -run)
+#   // EXPECT: <text>      must appear in the compiler's stdout or stderr
+#   // REJECT: <text>      must not appear in either
+#   // OUTPUT: <line>      one line of the program's output under -run; together the
+#                          OUTPUT lines must match the whole output exactly
+#   // STATUS: <code>      expected compiler exit status (default 0)
+#   // RUNS: <n>           run the compiler n times (default 1); the checks see the last run
+#   // LEAVES: <file>      a file the compiler leaves in its working directory; with any
+#                          LEAVES line every other new file fails the case. 'nothing'
+#                          expects none.
+# Directive text cannot contain ';', which CMake treats as a list separator.
+#
+# Expects -DCOMPILER=<path> -DCASE=<file.hs> -DWORK_DIR=<dir>. WORK_DIR is emptied and the
+# case copied there first, so files the compiler writes next to its input stay out of the
+# tree and LEAVES sees only this case's files.
+
+foreach(required COMPILER CASE WORK_DIR)
+    if(NOT DEFINED ${required})
+        message(FATAL_ERROR "run_case.cmake needs -D${required}=...")
+    endif()
+endforeach()
+
+set(arguments "-run")
+set(expected_status 0)
+set(runs 1)
+set(leaves "")
+set(checks_leaves FALSE)
+set(expects "")
+set(rejects "")
+set(output_lines "")
+set(checks_output FALSE)
+
+file(STRINGS "${CASE}" directives REGEX "^// [A-Z]+:")
+foreach(directive IN LISTS directives)
+    string(REGEX MATCH "^// ([A-Z]+): ?(.*)$" unused "${directive}")
+    set(kind "${CMAKE_MATCH_1}")
+    set(value "${CMAKE_MATCH_2}")
+    if(kind STREQUAL "ARGS")
+        separate_arguments(arguments UNIX_COMMAND "${value}")
+    elseif(kind STREQUAL "EXPECT")
+        list(APPEND expects "${value}")
+    elseif(kind STREQUAL "REJECT")
+        list(APPEND rejects "${value}")
+    elseif(kind STREQUAL "OUTPUT")
+        string(APPEND output_lines "${value}\n")
+        set(checks_output TRUE)
+    elseif(kind STREQUAL "STATUS")
+        set(expected_status "${value}")
+    elseif(kind STREQUAL "RUNS")
+        set(runs "${value}")
+    elseif(kind STREQUAL "LEAVES")
+        if(NOT value STREQUAL "nothing")
+            list(APPEND leaves "${value}")
+        endif()
+        set(checks_leaves TRUE)
+    else()
+        message(FATAL_ERROR "Unknown directive '${kind}' in ${CASE}")
+    endif()
+endforeach()
+
+get_filename_component(case_name "${CASE}" NAME)
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+configure_file("${CASE}" "${WORK_DIR}/${case_name}" COPYONLY)
+
+foreach(run RANGE 1 ${runs})
+    execute_process(
+        COMMAND "${COMPILER}" "${case_name}" --no-server ${arguments}
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE status
+        OUTPUT_VARIABLE stdout
+        ERROR_VARIABLE stderr
+    )
+endforeach()
+set(transcript "${stdout}${stderr}")
+
+set(failures "")
+if(NOT status STREQUAL expected_status)
+    string(APPEND failures "exit status was '${status}', expected ${expected_status}\n")
+endif()
+foreach(text IN LISTS expects)
+    string(FIND "${transcript}" "${text}" position)
+    if(position EQUAL -1)
+        string(APPEND failures "missing: ${text}\n")
+    endif()
+endforeach()
+foreach(text IN LISTS rejects)
+    string(FIND "${transcript}" "${text}" position)
+    if(NOT position EQUAL -1)
+        string(APPEND failures "unexpected: ${text}\n")
+    endif()
+endforeach()
+
+if(checks_output)
+    set(rule "----------------------------------------\n")
+    set(start_marker "Running compiled HumanScript program...\n${rule}")
+    string(FIND "${stdout}" "${start_marker}" start)
+    string(FIND "${stdout}" "${rule}HumanScript program finished" end REVERSE)
+    if(start EQUAL -1 OR end EQUAL -1)
+        string(APPEND failures "the program did not run\n")
+    else()
+        string(LENGTH "${start_marker}" marker_length)
+        math(EXPR start "${start} + ${marker_length}")
+        math(EXPR length "${end} - ${start}")
+        string(SUBSTRING "${stdout}" ${start} ${length} program_output)
+        if(NOT program_output STREQUAL output_lines)
+            string(APPEND failures "program output was:\n${program_output}expected:\n${output_lines}")
+        endif()
+    endif()
+endif()
+
+if(checks_leaves)
+    file(GLOB left_behind RELATIVE "${WORK_DIR}" "${WORK_DIR}/*")
+    list(REMOVE_ITEM left_behind "${case_name}" ${leaves})
+    if(left_behind)
+        string(APPEND failures "left behind: ${left_behind}\n")
+    endif()
+endif()
+
+if(failures)
+    message(FATAL_ERROR "${case_name} failed:\n${failures}--- compiler output ---\n${transcript}")
+endif()
@@ -0,0 +1,9 @@
+// A literal on the left of ?= moves to the right
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-canonicalization' fired 2 time(s)
+// EXPECT: [comparison-canonicalization] (5 ?= m) -> (m ?= 5)
+// OUTPUT: false
+// OUTPUT: true
+number m := 3;
+says 5 ?= m;
+says 3 ?= m;
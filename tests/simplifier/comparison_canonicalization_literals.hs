@@ -0,0 +1,8 @@
+// Must not fire: already canonical, or literals on both sides
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-canonicalization' fired 0 time(s)
+// OUTPUT: true
+// OUTPUT: true
+number m := 3;
+says m ?= 3;
+says 3 ?= 3;
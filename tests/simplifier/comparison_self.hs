@@ -0,0 +1,9 @@
+// A variable always equals itself
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-self' fired 2 time(s)
+// OUTPUT: true
+// OUTPUT: true
+text x := "q";
+number m := 3;
+says x ?= x;
+says m ?= m;
@@ -0,0 +1,10 @@
+// Must not fire: riel may hold NaN, and different variables are not the same value
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-self' fired 0 time(s)
+// OUTPUT: true
+// OUTPUT: false
+riel r := 1.5;
+number m := 3;
+number n := 4;
+says r ?= r;
+says m ?= n;
@@ -0,0 +1,7 @@
+// Must not fire: comparing with false negates, it is not an identity
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-with-true' fired 0 time(s)
+// OUTPUT: false
+number n := 7;
+logic b := n ?= 7;
+says b ?= false;
@@ -0,0 +1,8 @@
+// b ?= true is just b
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'comparison-with-true' fired 1 time(s)
+// EXPECT: [comparison-with-true] (b ?= true) -> b
+// OUTPUT: true
+number n := 7;
+logic b := n ?= 7;
+says b ?= true;
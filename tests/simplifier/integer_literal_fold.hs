@@ -0,0 +1,7 @@
+// Integer literals add at compile time, in lnumber once range inference widened the sum
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'integer-literal-fold' fired 2 time(s)
+// OUTPUT: 3
+// OUTPUT: 4000000000
+says 1 + 2;
+says 2000000000 + 2000000000;
@@ -0,0 +1,5 @@
+// Must not fire: the sum overflows lnumber
+// ARGS: -v --check
+// EXPECT: Simplifier rule 'integer-literal-fold' fired 0 time(s)
+// REJECT: [integer-literal-fold]
+says 9223372036854775807 + 1;
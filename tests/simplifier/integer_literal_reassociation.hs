@@ -0,0 +1,7 @@
+// (m + 1) + 2 becomes m + 3 when both sums are in the same type
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'integer-literal-reassociation' fired 1 time(s)
+// EXPECT: [integer-literal-reassociation] ((m + 1) + 2) -> (m + 3)
+// OUTPUT: 6
+number m := 3;
+says m + 1 + 2;
@@ -0,0 +1,5 @@
+// Must not fire: the two literals overflow lnumber when added first
+// ARGS: -v --check
+// EXPECT: Simplifier rule 'integer-literal-reassociation' fired 0 time(s)
+lnumber big := 0;
+says big + 9223372036854775807 + 1;
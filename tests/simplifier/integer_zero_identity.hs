@@ -0,0 +1,9 @@
+// Adding a zero literal to an integer of the same type is dropped on either side
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'integer-zero-identity' fired 2 time(s)
+// OUTPUT: 3
+// OUTPUT: 7
+number m := 3;
+lnumber n := 7;
+says m + 0;
+says 0 + n;
@@ -0,0 +1,6 @@
+// Must not fire: riel sums are not integer sums
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'integer-zero-identity' fired 0 time(s)
+// OUTPUT: 1.5
+riel r := 1.5;
+says r + 0;
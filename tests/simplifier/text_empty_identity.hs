@@ -0,0 +1,8 @@
+// Adding empty text to text is dropped on either side
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-empty-identity' fired 2 time(s)
+// OUTPUT: ab
+// OUTPUT: ab
+text x := "ab";
+says x + "";
+says "" + x;
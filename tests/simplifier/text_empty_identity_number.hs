@@ -0,0 +1,8 @@
+// Must not fire: with a number operand the sum converts the number to text
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-empty-identity' fired 0 time(s)
+// OUTPUT: 2
+// OUTPUT: 2
+number n := 2;
+says "" + n;
+says n + "";
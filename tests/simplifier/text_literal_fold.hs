@@ -0,0 +1,8 @@
+// Text and integer literals concatenate at compile time
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-literal-fold' fired 2 time(s)
+// EXPECT: [text-literal-fold] ("a" + 1) -> "a1"
+// OUTPUT: ab
+// OUTPUT: a1
+says "a" + "b";
+says "a" + 1;
@@ -0,0 +1,8 @@
+// Must not fire: text plus a number variable or a riel literal is left to run time
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-literal-fold' fired 0 time(s)
+// OUTPUT: a2
+// OUTPUT: r1.5
+number n := 2;
+says "a" + n;
+says "r" + 1.5;
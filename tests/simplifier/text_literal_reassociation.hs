@@ -0,0 +1,10 @@
+// Adjacent literals around a text operand merge on either side
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-literal-reassociation' fired 2 time(s)
+// EXPECT: [text-literal-reassociation] ((x + "a") + "b") -> (x + "ab")
+// EXPECT: [text-literal-reassociation] ("a" + ("b" + x)) -> ("ab" + x)
+// OUTPUT: qab
+// OUTPUT: abq
+text x := "q";
+says x + "a" + "b";
+says "a" + ("b" + x);
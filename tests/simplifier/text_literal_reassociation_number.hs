@@ -0,0 +1,6 @@
+// Must not fire: n + 1 is an integer sum, so it cannot become n + "1a"
+// ARGS: -v -run
+// EXPECT: Simplifier rule 'text-literal-reassociation' fired 0 time(s)
+// OUTPUT: 3a
+number n := 2;
+says n + 1 + "a";